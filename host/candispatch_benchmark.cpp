@@ -0,0 +1,206 @@
+// Decode cost per received frame: the dispatch table of can/candispatch.h against the switch chain it replaced
+// (parseMotorControllerCanMessage() and parseBoardcomputerCanMessage() from before the table, with the pointer casts
+// replaced by memcpy). The traffic is every feedback frame of the front and back board in turn, plus a share of
+// identifiers nobody decodes. Not part of ctest, run it on an idle machine:
+//   ./candispatch_benchmark
+
+// system includes
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// 3rdparty lib includes
+#include <bobbycar-can.h>
+
+// local includes
+#include "can/candispatch.h"
+#include "driving_modes/controllers.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using namespace bobbycar::protocol::can;
+
+constexpr uint32_t FRAMES = 20000000;
+
+template<typename T>
+T read(const twai_message_t &message)
+{
+    T value;
+    std::memcpy(&value, message.data, sizeof(value));
+    return value;
+}
+
+namespace baseline {
+    template<bool isBack>
+    bool parseMotorControllerCanMessage(const twai_message_t &message, Controller &controller)
+    {
+        switch (message.identifier)
+        {
+            case MotorController<isBack, false>::Feedback::DcLink:
+                controller.feedback.left.dcLink = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::DcLink:
+                controller.feedback.right.dcLink = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Speed:
+                controller.feedback.left.speed = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::Speed:
+                controller.feedback.right.speed = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Error:
+                controller.feedback.left.error = read<int8_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::Error:
+                controller.feedback.right.error = read<int8_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Angle:
+                controller.feedback.left.angle = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::Angle:
+                controller.feedback.right.angle = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::DcPhaA:
+                controller.feedback.left.dcPhaA = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::DcPhaA:
+                controller.feedback.right.dcPhaA = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::DcPhaB:
+                controller.feedback.left.dcPhaB = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::DcPhaB:
+                controller.feedback.right.dcPhaB = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::DcPhaC:
+                controller.feedback.left.dcPhaC = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::DcPhaC:
+                controller.feedback.right.dcPhaC = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Chops:
+                controller.feedback.left.chops = read<uint16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::Chops:
+                controller.feedback.right.chops = read<uint16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Hall:
+                controller.feedback.left.hallA = read<uint8_t>(message) & 1;
+                controller.feedback.left.hallB = read<uint8_t>(message) & 2;
+                controller.feedback.left.hallC = read<uint8_t>(message) & 4;
+                return true;
+            case MotorController<isBack, true>::Feedback::Hall:
+                controller.feedback.right.hallA = read<uint8_t>(message) & 1;
+                controller.feedback.right.hallB = read<uint8_t>(message) & 2;
+                controller.feedback.right.hallC = read<uint8_t>(message) & 4;
+                return true;
+            case MotorController<isBack, false>::Feedback::Voltage:
+            case MotorController<isBack, true>::Feedback::Voltage:
+                controller.feedback.batVoltage = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Temp:
+            case MotorController<isBack, true>::Feedback::Temp:
+                controller.feedback.boardTemp = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Id:
+                controller.feedback.left.id = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::Id:
+                controller.feedback.right.id = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, false>::Feedback::Iq:
+                controller.feedback.left.iq = read<int16_t>(message);
+                return true;
+            case MotorController<isBack, true>::Feedback::Iq:
+                controller.feedback.right.iq = read<int16_t>(message);
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // the boardcomputer inputs were not wired up yet, only the identifiers were matched
+    bool parseBoardcomputerCanMessage(const twai_message_t &message)
+    {
+        switch (message.identifier)
+        {
+            case Boardcomputer::Command::RawButtonPressed:
+            case Boardcomputer::Command::RawButtonReleased:
+            case Boardcomputer::Command::ButtonPressed:
+            case Boardcomputer::Command::ButtonReleased:
+            case Boardcomputer::Command::RawGas:
+            case Boardcomputer::Command::RawBrems:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool parse(const twai_message_t &message)
+    {
+        if (parseMotorControllerCanMessage<false>(message, controllers.unswapped_front)) return true;
+        if (parseMotorControllerCanMessage<true>(message, controllers.unswapped_back)) return true;
+        return parseBoardcomputerCanMessage(message);
+    }
+} // namespace baseline
+
+bool parseTable(const twai_message_t &message)
+{
+    const auto &route = can::dispatch::lookup(message.identifier);
+    if (!route.decode) return false;
+
+    route.decode(message, route.target == can::dispatch::Target::Board ? &controllers.unswapped(route.board) : nullptr);
+    return true;
+}
+
+// every feedback frame once, then one unknown identifier per four known ones
+std::vector<twai_message_t> traffic(const bool unknown)
+{
+    std::vector<uint32_t> identifiers;
+    for (const auto &entry: can::dispatch::entries)
+        if (entry.route.target == can::dispatch::Target::Board) identifiers.push_back(entry.identifier);
+
+    std::vector<twai_message_t> frames;
+    for (size_t i = 0; i < identifiers.size(); ++i)
+    {
+        twai_message_t message{};
+        message.identifier = identifiers[i];
+        message.data_length_code = 2;
+        message.data[0] = uint8_t(i);
+        frames.push_back(message);
+
+        if (unknown && i % 4 == 3)
+        {
+            message.identifier = 0x700 + i;
+            frames.push_back(message);
+        }
+    }
+    return frames;
+}
+
+template<typename Parse>
+void run(const char *name, const std::vector<twai_message_t> &frames, Parse parse)
+{
+    uint32_t decoded{};
+
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < FRAMES; ++i) decoded += parse(frames[i % frames.size()]);
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::printf("%-28s %.2f ns/frame (%u decoded, speed %d)\n", name, elapsed / FRAMES, decoded,
+                controllers.unswapped_back.feedback.right.speed);
+}
+} // namespace
+
+int main()
+{
+    const auto feedback = traffic(false);
+    const auto mixed = traffic(true);
+
+    run("switch chain, feedback", feedback, baseline::parse);
+    run("dispatch table, feedback", feedback, parseTable);
+    run("switch chain, 20% unknown", mixed, baseline::parse);
+    run("dispatch table, 20% unknown", mixed, parseTable);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+// system includes
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Reader for CAN flight recorder logs, see main/can/canrecorder.h for the layout. Shared by the host tools.
+namespace canlog {
+
+constexpr uint8_t FLAG_TX = 0x80;
+constexpr uint8_t RAW_IDENTIFIER = 0xFF;
+
+struct Frame
+{
+    int64_t timestamp; // us since boot
+    uint32_t identifier;
+    bool tx;
+    uint8_t length;
+    uint8_t data[15];
+};
+
+enum class Result
+{
+    Ok,
+    NotALog,
+    TruncatedDictionary,
+    TruncatedRecords,
+};
+
+struct Log
+{
+    uint32_t count; // records announced by the header, frames holds fewer if the log is truncated
+    std::vector<Frame> frames;
+};
+
+class Reader
+{
+public:
+    explicit Reader(std::vector<uint8_t> data) : m_data{std::move(data)}
+    {
+    }
+
+    bool read(void *out, const size_t size)
+    {
+        if (m_position + size > m_data.size()) return false;
+        std::memcpy(out, m_data.data() + m_position, size);
+        m_position += size;
+        return true;
+    }
+
+    template<typename T>
+    bool read(T &value)
+    {
+        return read(&value, sizeof(value));
+    }
+
+    bool readVarint(uint64_t &value)
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t byte;
+            if (!read(byte)) return false;
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+    size_t m_position{};
+};
+
+inline std::vector<uint8_t> load(const char *path)
+{
+    std::vector<uint8_t> data;
+    FILE *file = std::fopen(path, "rb");
+    if (!file) return data;
+
+    std::array<uint8_t, 4096> buffer;
+    while (const auto got = std::fread(buffer.data(), 1, buffer.size(), file))
+        data.insert(data.end(), buffer.begin(), buffer.begin() + got);
+
+    std::fclose(file);
+    return data;
+}
+
+inline Result decode(std::vector<uint8_t> data, Log &log)
+{
+    Reader reader{std::move(data)};
+
+    char magic[4];
+    uint16_t dictionarySize, reserved;
+    int64_t timestamp;
+    if (!reader.read(magic, sizeof(magic)) || std::memcmp(magic, "BCL1", 4) || !reader.read(dictionarySize) ||
+        !reader.read(reserved) || !reader.read(log.count) || !reader.read(timestamp))
+        return Result::NotALog;
+
+    std::vector<uint32_t> dictionary(dictionarySize);
+    if (!reader.read(dictionary.data(), dictionary.size() * sizeof(uint32_t))) return Result::TruncatedDictionary;
+
+    log.frames.clear();
+    log.frames.reserve(log.count);
+
+    for (uint32_t i = 0; i < log.count; ++i)
+    {
+        uint64_t delta;
+        uint8_t index, flags;
+        Frame frame;
+
+        if (!reader.readVarint(delta) || !reader.read(index)) return Result::TruncatedRecords;
+        if (index == RAW_IDENTIFIER)
+        {
+            if (!reader.read(frame.identifier)) return Result::TruncatedRecords;
+        }
+        else if (index < dictionary.size())
+            frame.identifier = dictionary[index];
+        else
+            return Result::TruncatedRecords;
+
+        if (!reader.read(flags) || !reader.read(frame.data, flags & 0x0F)) return Result::TruncatedRecords;
+
+        timestamp += int64_t(delta);
+
+        frame.timestamp = timestamp;
+        frame.tx = flags & FLAG_TX;
+        frame.length = flags & 0x0F;
+        log.frames.push_back(frame);
+    }
+
+    return Result::Ok;
+}
+
+} // namespace canlog
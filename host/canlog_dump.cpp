@@ -0,0 +1,50 @@
+// Decodes a CAN flight recorder log (see main/can/canrecorder.h for the layout) into candump's log format, which
+// canplayer from can-utils can replay onto a real or virtual bus:
+//   ./canlog_dump canlog0.bin > canlog0.log
+//   canplayer -I canlog0.log vcan0=rx
+// Frames we received are logged on interface "rx", frames we sent on "tx".
+
+// system includes
+#include <cstdio>
+
+// local includes
+#include "canlog.h"
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "usage: %s <canlogN.bin>\n", argv[0]);
+        return 2;
+    }
+
+    canlog::Log log;
+    const auto result = canlog::decode(canlog::load(argv[1]), log);
+
+    switch (result)
+    {
+        case canlog::Result::NotALog:
+            std::fprintf(stderr, "%s is not a CAN recorder log\n", argv[1]);
+            return 1;
+        case canlog::Result::TruncatedDictionary:
+            std::fprintf(stderr, "truncated dictionary\n");
+            return 1;
+        case canlog::Result::Ok:
+        case canlog::Result::TruncatedRecords:
+            break;
+    }
+
+    for (const auto &frame: log.frames)
+    {
+        std::printf("(%lld.%06lld) %s %03X#", (long long)(frame.timestamp / 1000000),
+                    (long long)(frame.timestamp % 1000000), frame.tx ? "tx" : "rx", unsigned(frame.identifier));
+        for (unsigned byte = 0; byte < frame.length; ++byte) std::printf("%02X", frame.data[byte]);
+        std::printf("\n");
+    }
+
+    if (result == canlog::Result::TruncatedRecords)
+    {
+        std::fprintf(stderr, "log ends after %zu of %u frames\n", log.frames.size(), log.count);
+        return 1;
+    }
+}
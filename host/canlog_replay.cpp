@@ -0,0 +1,164 @@
+// Replays the frames we received in a CAN flight recorder log through the firmware's receive path, once through
+// drainCanInput() and once frame by frame through tryParseCanInput(). Both have to end up with the last speed each
+// motor reported and the last remote pedal values in the log. Reports the decode throughput, including the queue of
+// the shim driver:
+//   ./canlog_replay [canlogN.bin] [passes]
+// Without arguments it replays spiffs/canlog0.bin, the log firmware_test_full writes on its bus error.
+
+// system includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+// local includes
+#include "canlog.h"
+#include "firmwarebus.h"
+
+using namespace firmwarebus;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Expected
+{
+    std::optional<int16_t> speed[4]; // front left, front right, back left, back right
+    std::optional<int16_t> gas;
+    std::optional<int16_t> brems;
+};
+
+int16_t int16At(const twai_message_t &message)
+{
+    return int16_t(message.data[0] | message.data[1] << 8);
+}
+
+Expected expectedState(const std::vector<twai_message_t> &frames)
+{
+    constexpr uint32_t speedIdentifiers[]{
+            MotorController<false, false>::Feedback::Speed,
+            MotorController<false, true>::Feedback::Speed,
+            MotorController<true, false>::Feedback::Speed,
+            MotorController<true, true>::Feedback::Speed,
+    };
+
+    Expected expected;
+    for (const auto &message: frames)
+    {
+        if (message.data_length_code < sizeof(int16_t)) continue;
+
+        for (size_t motor = 0; motor < std::size(speedIdentifiers); ++motor)
+            if (message.identifier == speedIdentifiers[motor]) expected.speed[motor] = int16At(message);
+
+        if (message.identifier == Boardcomputer::Command::RawGas) expected.gas = int16At(message);
+        if (message.identifier == Boardcomputer::Command::RawBrems) expected.brems = int16At(message);
+    }
+    return expected;
+}
+
+void resetFeedback()
+{
+    for (size_t i = 0; i < controllers.size(); ++i)
+    {
+        auto &controller = controllers.unswapped(i);
+        controller.feedback = {};
+        controller.feedbackValid = false;
+    }
+}
+
+void checkState(const Expected &expected)
+{
+    for (size_t motor = 0; motor < std::size(expected.speed); ++motor)
+    {
+        const auto board = motor / 2;
+        if (!expected.speed[motor] || board >= controllers.size()) continue;
+
+        const auto &controller = controllers.unswapped(board);
+        HOST_CHECK(controller.feedbackValid);
+        HOST_CHECK((motor % 2 ? controller.feedback.right.speed : controller.feedback.left.speed) ==
+                   *expected.speed[motor]);
+    }
+
+    if (expected.gas) HOST_CHECK(can::can_external::canGas.load() == expected.gas);
+    if (expected.brems) HOST_CHECK(can::can_external::canBrems.load() == expected.brems);
+}
+
+void report(const char *name, const size_t frames, const Clock::duration elapsed)
+{
+    const auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+    std::printf("%s: %zu frames, %.1f ns/frame, %.0f frames/s\n", name, frames, ns / frames, frames / ns * 1e9);
+}
+
+// the queue of the shim driver is as long as the firmware configured it, drain whenever it is full
+void replayDrained(const std::vector<twai_message_t> &frames, const unsigned passes)
+{
+    const auto start = Clock::now();
+    for (unsigned pass = 0; pass < passes; ++pass)
+    {
+        for (const auto &message: frames)
+            while (!hostshim::twai::receive(message)) can::drainCanInput();
+
+        do
+            can::drainCanInput();
+        while (can::stats::rxDrained.load());
+    }
+    report("drainCanInput()", frames.size() * passes, Clock::now() - start);
+}
+
+void replayOneByOne(const std::vector<twai_message_t> &frames, const unsigned passes)
+{
+    const auto start = Clock::now();
+    for (unsigned pass = 0; pass < passes; ++pass)
+    {
+        for (const auto &message: frames)
+        {
+            HOST_CHECK(hostshim::twai::receive(message));
+            HOST_CHECK(can::tryParseCanInput());
+        }
+    }
+    report("tryParseCanInput()", frames.size() * passes, Clock::now() - start);
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "spiffs/canlog0.bin";
+    const unsigned passes = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1;
+
+    canlog::Log log;
+    if (const auto result = canlog::decode(canlog::load(path), log); result != canlog::Result::Ok)
+    {
+        std::fprintf(stderr, "could not read %s\n", path);
+        return 1;
+    }
+
+    std::vector<twai_message_t> received;
+    for (const auto &frame: log.frames)
+    {
+        if (frame.tx) continue;
+
+        twai_message_t message{};
+        message.identifier = frame.identifier;
+        message.data_length_code = std::min<uint8_t>(frame.length, sizeof(message.data));
+        std::memcpy(message.data, frame.data, message.data_length_code);
+        received.push_back(message);
+    }
+    HOST_CHECK(!received.empty());
+
+    const auto expected = expectedState(received);
+
+    boot();
+
+    replayDrained(received, passes);
+    checkState(expected);
+
+    resetFeedback();
+
+    replayOneByOne(received, passes);
+    checkState(expected);
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+// system includes
+#include <cstdint>
+
+// local includes
+#include "can/canoutputskernel.h"
+#include "hostcheck.h"
+
+using namespace can::outputs;
+
+int main()
+{
+    // 255mm wheel: 0.255m * pi per revolution, 60 revolutions per hour and rpm
+    HOST_CHECK_NEAR(rpmToKmh(255.f), 0.048066f, 1e-5);
+
+    constexpr float filterTimeS = 0.1f;
+
+    // the first sample has nothing to derive from
+    Acceleration acceleration;
+    updateAcceleration(acceleration, 10.f, 1000000, filterTimeS);
+    HOST_CHECK(acceleration.valid);
+    HOST_CHECK(acceleration.value == 0.f);
+
+    // a steady 1 m/s^2 ramp sampled every 10ms settles at 1 m/s^2
+    int64_t timestamp = 1000000;
+    float speedKmh = 10.f;
+    for (int i = 0; i < 200; ++i)
+    {
+        timestamp += 10000;
+        speedKmh += 0.01f * 3.6f;
+        updateAcceleration(acceleration, speedKmh, timestamp, filterTimeS);
+    }
+    HOST_CHECK_NEAR(acceleration.value, 1.f, 1e-2);
+
+    // other lanes republishing the same speed frame must not pull it towards zero
+    const float before = acceleration.value;
+    for (int i = 0; i < 50; ++i) updateAcceleration(acceleration, speedKmh, timestamp, filterTimeS);
+    HOST_CHECK(acceleration.value == before);
+
+    // after losing every board the next sample starts over
+    acceleration.valid = false;
+    updateAcceleration(acceleration, 0.f, timestamp + 10000, filterTimeS);
+    HOST_CHECK(acceleration.value == 0.f);
+}
@@ -0,0 +1,94 @@
+// Driver restarts that catch the controller bus off or still recovering, with and without reinstalling the driver.
+// twai_stop() and twai_start() fail in both states, a restart that relies on them never gets the bus back.
+
+// local includes
+#include "firmwarebus.h"
+
+using namespace firmwarebus;
+
+namespace {
+
+// longer than RECOVERY_TIMEOUT in can.cpp
+constexpr TickType_t RECOVERY_TIMED_OUT = pdMS_TO_TICKS(600);
+
+// too many failed transmissions schedule a restart, and the controller goes bus off before the restart runs
+void busOffBeforeRestart()
+{
+    for (int i = 0; i <= CONFIG_BOBBYCAR_CAN_CONTROLLER_MAX_ERROR_COUNT; ++i)
+    {
+        hostshim::twai::raiseAlerts(TWAI_ALERT_TX_FAILED);
+        can::updateCan();
+    }
+    hostshim::twai::busOff();
+}
+
+void checkSending()
+{
+    const auto sent = tick(100, 0, 0);
+    HOST_CHECK(find(sent, MotorController<false, false>::Command::InpTgt));
+}
+
+} // namespace
+
+int main()
+{
+    boot();
+    checkSending();
+
+    // restarts after TX failures and recovery timeouts are opt-in
+    auto &hardware = config::configs.controllerHardware;
+    HOST_CHECK(config::writeConfig(hardware.canBusResetOnError, true));
+
+    const auto installs = hostshim::twai::installCount();
+    const auto recoveries = can::stats::busRecoveries.load();
+
+    // == without reinstall, a bus off controller is recovered instead of started == //
+    HOST_CHECK(config::writeConfig(hardware.canUninstallOnReset, false));
+
+    busOffBeforeRestart();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RECOVERING);
+
+    // a recovery that times out and is still running is waited for again, it cannot be stopped
+    vTaskDelay(RECOVERY_TIMED_OUT);
+    can::updateCan();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RECOVERING);
+
+    hostshim::twai::recover();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RUNNING);
+    HOST_CHECK(hostshim::twai::installCount() == installs);
+    HOST_CHECK(can::stats::busRecoveries == recoveries + 1);
+    checkSending();
+
+    // == with reinstall, a bus off controller gets a fresh driver == //
+    HOST_CHECK(config::writeConfig(hardware.canUninstallOnReset, true));
+
+    busOffBeforeRestart();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RUNNING);
+    HOST_CHECK(hostshim::twai::installCount() == installs + 1);
+    HOST_CHECK(can::stats::busRecoveries == recoveries + 2);
+    checkSending();
+
+    // == but not while it is recovering, uninstalling is not allowed then == //
+    hostshim::twai::busOff();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RECOVERING);
+
+    vTaskDelay(RECOVERY_TIMED_OUT);
+    can::updateCan();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RECOVERING);
+    HOST_CHECK(hostshim::twai::installed());
+
+    hostshim::twai::recover();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RUNNING);
+    HOST_CHECK(hostshim::twai::installCount() == installs + 1);
+    HOST_CHECK(can::stats::busRecoveries == recoveries + 3);
+    checkSending();
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Boots the firmware against the host shim the way app_main() does and drives it through the CAN bus: feedback in,
+// remote pedals in, commands out, a config change and a bus off recovery. With the recorder built in, the bus error
+// also writes a log to ./spiffs that the canlog_replay test picks up.
+
+// local includes
+#include "canlog.h"
+#include "firmwarebus.h"
+#include "tasks/taskmanager.h"
+
+using namespace firmwarebus;
+
+int main()
+{
+    boot();
+
+    HOST_CHECK(sched_findTask("can"));
+    HOST_CHECK(sched_findTask("drive"));
+    HOST_CHECK(!sched_findTask("nonexistent"));
+
+    // == feedback == //
+    auto sent = tick(200, 0, 0);
+
+    // no board sent packed feedback, every board gets its own InpTgt frames right from boot
+    HOST_CHECK(find(sent, MotorController<false, false>::Command::InpTgt));
+    HOST_CHECK(find(sent, MotorController<true, true>::Command::InpTgt));
+
+    for (size_t i = 0; i < controllers.size(); ++i)
+    {
+        HOST_CHECK(controllers.unswapped(i).feedbackValid);
+        HOST_CHECK(controllers.unswapped(i).feedback.left.speed == 200);
+        HOST_CHECK(controllers.unswapped(i).feedback.batVoltage == 3600);
+    }
+    HOST_CHECK_NEAR(can::outputs::averageSpeed.load(), 200, 0.01);
+
+    // == remote gas turns into InpTgt on every motor == //
+    for (int i = 0; i < 50; ++i)
+    {
+        sent = tick(200, 1000, 0);
+        if (const auto *inpTgt = find(sent, MotorController<false, false>::Command::InpTgt);
+            inpTgt && value<int16_t>(*inpTgt) > 0)
+            break;
+    }
+
+    HOST_CHECK(find(sent, MotorController<false, false>::Command::InpTgt));
+    HOST_CHECK(find(sent, MotorController<false, true>::Command::InpTgt));
+    HOST_CHECK(find(sent, MotorController<true, false>::Command::InpTgt));
+    HOST_CHECK(find(sent, MotorController<true, true>::Command::InpTgt));
+    HOST_CHECK(value<int16_t>(*find(sent, MotorController<false, false>::Command::InpTgt)) > 0);
+    HOST_CHECK(value<int16_t>(*find(sent, MotorController<false, true>::Command::InpTgt)) < 0);
+
+    // == a config write goes out within the TX budget of the next few ticks == //
+    HOST_CHECK(config::writeConfig(config::selectedProfile->limits.iMotMax, int16_t{10}));
+
+    bool iMotMaxSent{};
+    for (int i = 0; i < 50 && !iMotMaxSent; ++i)
+    {
+        sent = tick(200, 1000, 0);
+        const auto *iMotMax = find(sent, MotorController<false, false>::Command::IMotMax);
+        iMotMaxSent = iMotMax && value<uint8_t>(*iMotMax) == 10;
+    }
+    HOST_CHECK(iMotMaxSent);
+
+    // the write went to the in-memory NVS and survives a reload
+    HOST_CHECK(config::configs.init("bobbycar") == ESP_OK);
+    HOST_CHECK(config::selectedProfile->limits.iMotMax.value() == 10);
+
+    // == bus off, recovery and back to sending == //
+    const auto recoveries = can::stats::busRecoveries.load();
+
+    hostshim::twai::busOff();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RECOVERING);
+    HOST_CHECK(can::stats::busRecoveries == recoveries + 1);
+
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+    // the bus error flushes the recorder, the log holds the traffic above in both directions
+    can::recorder::update();
+    HOST_CHECK(can::recorder::flushedLogs == 1);
+
+    canlog::Log log;
+    HOST_CHECK(canlog::decode(canlog::load("spiffs/canlog0.bin"), log) == canlog::Result::Ok);
+    HOST_CHECK(log.frames.size() == log.count);
+    HOST_CHECK(std::ranges::any_of(log.frames, [](const canlog::Frame &frame) {
+        return !frame.tx && frame.identifier == MotorController<true, true>::Feedback::Speed &&
+               int16_t(frame.data[0] | frame.data[1] << 8) == -200;
+    }));
+    HOST_CHECK(std::ranges::any_of(log.frames, [](const canlog::Frame &frame) {
+        return frame.tx && frame.identifier == MotorController<false, false>::Command::IMotMax && frame.data[0] == 10;
+    }));
+    HOST_CHECK(std::ranges::is_sorted(log.frames, {}, &canlog::Frame::timestamp));
+#endif
+
+    hostshim::twai::recover();
+    can::updateCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RUNNING);
+
+    sent = tick(200, 1000, 0);
+    HOST_CHECK(find(sent, MotorController<false, false>::Command::InpTgt));
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// system includes
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// esp-idf includes
+#include <driver/twai.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <hostshim.h>
+
+// 3rdparty lib includes
+#include <bobbycar-can.h>
+
+// local includes
+#include "can/can.h"
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+#include "can/canrecorder.h"
+#endif
+#include "config/config.h"
+#include "driving_modes/controllers.h"
+#include "driving_modes/drive.h"
+#include "hostcheck.h"
+#include "utils/crashloop.h"
+
+// Drives the firmware libraries through the CAN bus of the host shim, shared by the firmware tests.
+namespace firmwarebus {
+
+using namespace bobbycar::protocol::can;
+
+template<typename T>
+twai_message_t frame(const uint32_t identifier, const T value)
+{
+    twai_message_t message{};
+    message.identifier = identifier;
+    message.data_length_code = sizeof(value);
+    std::memcpy(message.data, &value, sizeof(value));
+    return message;
+}
+
+template<bool isBack>
+void sendFeedback(const int16_t speed)
+{
+    // right motors are mounted the other way round, invertFrontRight/invertBackRight are set by default
+    HOST_CHECK(hostshim::twai::receive(frame(MotorController<isBack, false>::Feedback::Speed, speed)));
+    HOST_CHECK(hostshim::twai::receive(frame(MotorController<isBack, true>::Feedback::Speed, int16_t(-speed))));
+    HOST_CHECK(hostshim::twai::receive(frame(MotorController<isBack, false>::Feedback::Voltage, int16_t{3600})));
+}
+
+inline void sendPedals(const int16_t gas, const int16_t brems)
+{
+    HOST_CHECK(hostshim::twai::receive(frame(Boardcomputer::Command::RawGas, gas)));
+    HOST_CHECK(hostshim::twai::receive(frame(Boardcomputer::Command::RawBrems, brems)));
+}
+
+// the boot sequence of app_main() up to the scheduler
+inline void boot()
+{
+    esp_log_level_set("*", ESP_LOG_WARN);
+
+    init::checkCrashLoop();
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+    can::recorder::begin();
+#endif
+
+    HOST_CHECK(config::configs.init("bobbycar") == ESP_OK);
+    config::switchProfile(config::configs.profileIndex.value());
+
+    can::initCan();
+    HOST_CHECK(hostshim::twai::state() == TWAI_STATE_RUNNING);
+
+    driving_modes::initDrive();
+    HOST_CHECK(currentMode);
+}
+
+// one control tick: the bus delivers feedback and pedals, then the CAN and drive tasks run like the realtime
+// scheduler would. With CONFIG_BOBBYCAR_CAN_RX_TASK the frames take a detour through can_rx, so the CAN task keeps
+// draining until they are decoded. Returns the frames sent since the last tick.
+inline std::vector<twai_message_t> tick(const int16_t speed, const int16_t gas, const int16_t brems)
+{
+    sendFeedback<false>(speed);
+    sendFeedback<true>(speed);
+    sendPedals(gas, brems);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        can::updateCan();
+        if (controllers.unswapped_back.feedback.right.speed == -speed && can::can_external::freshBrems() == brems)
+            break;
+        vTaskDelay(1);
+    }
+
+    driving_modes::updateDrive();
+
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_BOBBYCAR_DRIVE_UPDATE_INTERVAL_MS));
+
+    return hostshim::twai::transmitted();
+}
+
+inline const twai_message_t *find(const std::vector<twai_message_t> &frames, const uint32_t identifier)
+{
+    const auto iter = std::ranges::find(frames, identifier, &twai_message_t::identifier);
+    return iter != frames.end() ? &*iter : nullptr;
+}
+
+template<typename T>
+T value(const twai_message_t &message)
+{
+    T result;
+    std::memcpy(&result, message.data, sizeof(result));
+    return result;
+}
+
+} // namespace firmwarebus
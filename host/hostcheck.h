@@ -0,0 +1,21 @@
+#pragma once
+
+// system includes
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the host targets, the firmware builds without exceptions so no test framework is pulled in.
+// A failing check prints where it failed and aborts the test binary.
+#define HOST_CHECK(cond)                                                                                               \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);                             \
+            std::abort();                                                                                              \
+        }                                                                                                              \
+    } while (false)
+
+#define HOST_CHECK_NEAR(actual, expected, tolerance)                                                                   \
+    HOST_CHECK(std::fabs(double(actual) - double(expected)) <= (tolerance))
@@ -0,0 +1,30 @@
+// system includes
+#include <cstdint>
+
+// local includes
+#include "hostcheck.h"
+#include "utils/loghistogram.h"
+
+int main()
+{
+    LogHistogram<> histogram;
+    HOST_CHECK(histogram.count() == 0);
+    HOST_CHECK(histogram.percentile(50) == 0);
+
+    // bucket 0 takes 0, bucket i takes [2^(i-1), 2^i)
+    for (uint32_t i = 0; i < 90; ++i) histogram.record(3);
+    for (uint32_t i = 0; i < 9; ++i) histogram.record(100);
+    histogram.record(100000);
+
+    HOST_CHECK(histogram.count() == 100);
+    HOST_CHECK(histogram.max() == 100000);
+    HOST_CHECK(histogram.percentile(50) == 3);
+    HOST_CHECK(histogram.percentile(90) == 3);
+    HOST_CHECK(histogram.percentile(99) == 127);
+    // the last bucket is open ended and reports max()
+    HOST_CHECK(histogram.percentile(100) == 100000);
+
+    histogram.reset();
+    HOST_CHECK(histogram.count() == 0);
+    HOST_CHECK(histogram.max() == 0);
+}
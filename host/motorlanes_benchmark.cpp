@@ -0,0 +1,117 @@
+// Cost of the per-tick wheel aggregation of can::outputs::update(): the masked loop over the motorlanes (one array per
+// quantity) against the per-board loop over Controller::feedback it replaced. Every step one wheel gets a new speed
+// and one board drops out now and then, so neither loop can be hoisted. Not part of ctest, run it on an idle machine:
+//   ./motorlanes_benchmark
+
+// system includes
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// local includes
+#include "driving_modes/controllers.h"
+#include "driving_modes/motorlanes.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t STEPS = 20000000;
+
+// front left, front right, back left, back right, boards past the back one are mounted like it
+const motorlanes::Lane<float> speedSign = [] {
+    motorlanes::Lane<float> sign;
+    for (size_t i = 0; i < sign.size(); ++i) sign[i] = i % 2 ? -1.f : 1.f;
+    return sign;
+}();
+
+struct Sums
+{
+    float speed;
+    float current;
+    uint8_t motors;
+};
+
+// the loop of can::outputs::update() before the lanes
+Sums aggregateBoards()
+{
+    Sums sums{};
+
+    for (size_t board = 0; board < controllers.size(); ++board)
+    {
+        const auto &controller = controllers.unswapped(board);
+        if (!controller.feedbackValid) continue;
+
+        const auto &feedback = controller.feedback;
+        const auto left = motorlanes::index(board, false);
+        const auto right = motorlanes::index(board, true);
+        sums.speed += speedSign[left] * feedback.left.speed + speedSign[right] * feedback.right.speed;
+        sums.current += feedback.left.dcLink + feedback.right.dcLink;
+        sums.motors += 2;
+    }
+    return sums;
+}
+
+// the loop of can::outputs::update() now
+Sums aggregateLanes()
+{
+    const auto &lanes = motorlanes::feedback;
+    Sums sums{};
+
+    for (size_t i = 0; i < motorlanes::COUNT; ++i)
+    {
+        const float valid = lanes.valid[i];
+        sums.speed += valid * speedSign[i] * lanes.speed[i];
+        sums.current += valid * lanes.dcLink[i];
+        sums.motors += lanes.valid[i];
+    }
+    return sums;
+}
+
+void feedBoards(const uint32_t step)
+{
+    const auto board = step / 2 % controllers.size();
+    auto &controller = controllers.unswapped(board);
+    auto &motor = step % 2 ? controller.feedback.right : controller.feedback.left;
+    motor.speed = int16_t(step % 1000);
+    motor.dcLink = int16_t(step % 300);
+    controller.feedbackValid = step % 64 != 0;
+}
+
+void feedLanes(const uint32_t step)
+{
+    const auto board = step / 2 % controllers.size();
+    auto &lanes = motorlanes::feedback;
+    const auto i = motorlanes::index(board, step % 2);
+    lanes.speed[i] = int16_t(step % 1000);
+    lanes.dcLink[i] = int16_t(step % 300);
+    lanes.valid[motorlanes::index(board, false)] = lanes.valid[motorlanes::index(board, true)] = step % 64 != 0;
+}
+
+template<typename Feed, typename Aggregate>
+void run(const char *name, Feed feed, Aggregate aggregate)
+{
+    float speed{};
+    float current{};
+    uint32_t motors{};
+
+    const auto start = Clock::now();
+    for (uint32_t step = 0; step < STEPS; ++step)
+    {
+        feed(step);
+        const auto sums = aggregate();
+        speed += sums.speed;
+        current += sums.current;
+        motors += sums.motors;
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    std::printf("%-24s %.2f ns/tick (speed %.0f, current %.0f, motors %u)\n", name, elapsed / STEPS, speed, current,
+                motors);
+}
+} // namespace
+
+int main()
+{
+    run("per board (AoS)", feedBoards, aggregateBoards);
+    run("motorlanes (SoA)", feedLanes, aggregateLanes);
+}
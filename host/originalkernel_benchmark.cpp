@@ -0,0 +1,90 @@
+// Cost of one OriginalMode kernel step on a synthetic pedal trace: ramping gas into field weakening, holding,
+// braking back out and idling. Not part of ctest, run it on an idle machine:
+//   ./originalkernel_benchmark
+
+// system includes
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// local includes
+#include "driving_modes/originalkernel.h"
+
+using namespace driving_modes::original;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t TICKS = 20000000;
+constexpr size_t TRACE_LENGTH = 4000;
+constexpr float DT_MS = 10.f;
+
+struct Pedals
+{
+    float gas;
+    float brems;
+};
+
+std::array<Pedals, TRACE_LENGTH> makeTrace()
+{
+    std::array<Pedals, TRACE_LENGTH> trace;
+    for (size_t i = 0; i < trace.size(); ++i)
+    {
+        const auto phase = i * 4 / trace.size();
+        const auto progress = float(i % (trace.size() / 4)) / (trace.size() / 4);
+        switch (phase)
+        {
+            case 0: trace[i] = {1000.f * progress, 0.f}; break;
+            case 1: trace[i] = {1000.f, 0.f}; break;
+            case 2: trace[i] = {0.f, 1000.f * progress}; break;
+            default: trace[i] = {0.f, 0.f}; break;
+        }
+    }
+    return trace;
+}
+
+void run(const char *name, const Params &params)
+{
+    const auto trace = makeTrace();
+    State state;
+    float sink{};
+
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < TICKS; ++i)
+    {
+        const auto &pedals = trace[i % trace.size()];
+        const auto output = step(params, state, pedals.gas, pedals.brems, DT_MS);
+        sink += output.front + output.back;
+    }
+    const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    // printing the sum keeps the loop from being optimized away
+    std::printf("%s: %.2f ns/tick (checksum %g)\n", name, elapsed / TICKS, double(sink));
+}
+} // namespace
+
+int main()
+{
+    Params params{
+            .squareGas = true,
+            .squareBrems = true,
+            .enableSmoothingUp = true,
+            .enableSmoothingDown = true,
+            .enableFieldWeakSmoothingUp = false,
+            .enableFieldWeakSmoothingDown = true,
+            .smoothing = 20.f,
+            .frontPercentage = 100.f,
+            .backPercentage = 100.f,
+            .addSchwelle = 950.f,
+            .gas1Wert = 1250.f,
+            .gas2Wert = 1000.f,
+            .brems1Wert = 250.f,
+            .brems2Wert = 750.f,
+            .fwSmoothLowerLimit = 800.f,
+    };
+    run("smoothed", params);
+
+    params.smoothing = 0.f;
+    run("unlimited", params);
+}
@@ -0,0 +1,84 @@
+// local includes
+#include "driving_modes/originalkernel.h"
+#include "hostcheck.h"
+
+using namespace driving_modes::original;
+
+namespace {
+Params defaultParams()
+{
+    return {
+            .squareGas = false,
+            .squareBrems = false,
+            .enableSmoothingUp = true,
+            .enableSmoothingDown = true,
+            .enableFieldWeakSmoothingUp = false,
+            .enableFieldWeakSmoothingDown = true,
+            .smoothing = 20.f,
+            .frontPercentage = 100.f,
+            .backPercentage = 50.f,
+            .addSchwelle = 500.f,
+            .gas1Wert = 1250.f,
+            .gas2Wert = 1000.f,
+            .brems1Wert = 250.f,
+            .brems2Wert = 750.f,
+            .fwSmoothLowerLimit = 800.f,
+    };
+}
+} // namespace
+
+int main()
+{
+    const auto params = defaultParams();
+
+    // below add_schwelle the gas2/brems2 curve passes straight through
+    {
+        State state;
+        const auto output = step(params, state, 400.f, 0.f, 10.f);
+        HOST_CHECK_NEAR(output.front, 400.f, 1e-3);
+        HOST_CHECK_NEAR(output.back, 200.f, 1e-3);
+    }
+
+    // above add_schwelle pwm jumps to 1000 and only the field weakening part is rate limited
+    {
+        State state;
+        auto output = step(params, state, 1000.f, 0.f, 10.f);
+        HOST_CHECK_NEAR(output.front, 1000.f, 1e-3);
+
+        output = step(params, state, 1000.f, 0.f, 10.f);
+        HOST_CHECK_NEAR(output.front, 1002.f, 1e-3);
+
+        for (int i = 0; i < 1000; ++i) output = step(params, state, 1000.f, 0.f, 10.f);
+        HOST_CHECK_NEAR(output.front, 1250.f, 1e-3);
+    }
+
+    // braking out of field weakening is rate limited as well
+    {
+        State state{.lastPwm = 1250.f};
+        const auto output = step(params, state, 0.f, 1000.f, 10.f);
+        HOST_CHECK_NEAR(output.front, 1248.f, 1e-3);
+    }
+
+    // no smoothing rate, zero or negative, disables the rate limit instead of turning the bounds around
+    for (const float smoothing : {0.f, -20.f})
+    {
+        auto unlimited = params;
+        unlimited.smoothing = smoothing;
+        State state{.lastPwm = 1250.f};
+        auto output = step(unlimited, state, 0.f, 1000.f, 10.f);
+        HOST_CHECK_NEAR(output.front, -750.f, 1e-3);
+
+        state = {};
+        output = step(unlimited, state, 1000.f, 0.f, 10.f);
+        HOST_CHECK_NEAR(output.front, 1250.f, 1e-3);
+    }
+
+    // squared pedals
+    {
+        auto squared = params;
+        squared.squareGas = true;
+        State state;
+        const auto output = step(squared, state, 400.f, 0.f, 10.f);
+        HOST_CHECK_NEAR(output.front, 160.f, 1e-3);
+    }
+}
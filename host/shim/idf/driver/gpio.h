@@ -0,0 +1,13 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name.
+
+typedef enum {
+    GPIO_NUM_NC = -1,
+    GPIO_NUM_0 = 0,
+    GPIO_NUM_4 = 4,
+    GPIO_NUM_5 = 5,
+    GPIO_NUM_21 = 21,
+    GPIO_NUM_22 = 22,
+    GPIO_NUM_MAX = 40
+} gpio_num_t;
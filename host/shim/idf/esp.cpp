@@ -0,0 +1,160 @@
+// system includes
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+
+// local includes
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "hostshim.h"
+
+namespace {
+
+std::atomic<esp_reset_reason_t> resetReason{ESP_RST_POWERON};
+
+struct LogLevels
+{
+    std::mutex mutex;
+    esp_log_level_t fallback{ESP_LOG_INFO};
+    std::map<std::string, esp_log_level_t> tags;
+};
+
+// never destroyed, detached tasks may still log while the process exits
+LogLevels &logLevels()
+{
+    static auto &levels = *new LogLevels;
+    return levels;
+}
+
+char levelLetter(const esp_log_level_t level)
+{
+    switch (level)
+    {
+        case ESP_LOG_ERROR:
+            return 'E';
+        case ESP_LOG_WARN:
+            return 'W';
+        case ESP_LOG_INFO:
+            return 'I';
+        case ESP_LOG_DEBUG:
+            return 'D';
+        case ESP_LOG_VERBOSE:
+            return 'V';
+        case ESP_LOG_NONE:
+            break;
+    }
+    return '?';
+}
+
+} // namespace
+
+const char *esp_err_to_name(const esp_err_t code)
+{
+    switch (code)
+    {
+        case ESP_OK:
+            return "ESP_OK";
+        case ESP_FAIL:
+            return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:
+            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:
+            return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:
+            return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:
+            return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:
+            return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:
+            return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:
+            return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_NVS_NOT_INITIALIZED:
+            return "ESP_ERR_NVS_NOT_INITIALIZED";
+        case ESP_ERR_NVS_NOT_FOUND:
+            return "ESP_ERR_NVS_NOT_FOUND";
+        case ESP_ERR_NVS_READ_ONLY:
+            return "ESP_ERR_NVS_READ_ONLY";
+        case ESP_ERR_NVS_INVALID_HANDLE:
+            return "ESP_ERR_NVS_INVALID_HANDLE";
+        case ESP_ERR_NVS_KEY_TOO_LONG:
+            return "ESP_ERR_NVS_KEY_TOO_LONG";
+        case ESP_ERR_NVS_INVALID_LENGTH:
+            return "ESP_ERR_NVS_INVALID_LENGTH";
+    }
+    return "UNKNOWN ERROR";
+}
+
+void esp_log_level_set(const char *tag, const esp_log_level_t level)
+{
+    auto &levels = logLevels();
+    std::lock_guard lock{levels.mutex};
+
+    if (std::strcmp(tag, "*") == 0)
+    {
+        levels.fallback = level;
+        levels.tags.clear();
+    }
+    else
+    {
+        levels.tags[tag] = level;
+    }
+}
+
+void esp_log_write(const esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    {
+        auto &levels = logLevels();
+        std::lock_guard lock{levels.mutex};
+
+        const auto iter = levels.tags.find(tag);
+        if (level > (iter != levels.tags.end() ? iter->second : levels.fallback)) return;
+    }
+
+    // one fprintf per line, lines of different tasks do not get mixed
+    char message[256];
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    std::fprintf(stderr, "%c (%lld) %s: %s\n", levelLetter(level), (long long)(esp_timer_get_time() / 1000), tag,
+                 message);
+}
+
+int64_t esp_timer_get_time()
+{
+    using namespace std::chrono;
+
+    static const auto epoch = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - epoch).count();
+}
+
+esp_reset_reason_t esp_reset_reason()
+{
+    return resetReason.load();
+}
+
+void esp_restart()
+{
+    std::fprintf(stderr, "esp_restart() called\n");
+    std::abort();
+}
+
+namespace hostshim::system {
+
+void setResetReason(const esp_reset_reason_t reason)
+{
+    resetReason = reason;
+}
+
+} // namespace hostshim::system
@@ -0,0 +1,8 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name. There is no RTC or IRAM on the host, NOINIT variables are
+// zero initialized like every other static, which looks like a power on reset.
+
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define __NOINIT_ATTR
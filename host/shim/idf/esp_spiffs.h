@@ -0,0 +1,20 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name. The partition is a directory named after partition_label in
+// the working directory, fopen() of a path below base_path opens the file in there.
+
+// system includes
+#include <cstddef>
+
+// local includes
+#include "esp_err.h"
+
+typedef struct
+{
+    const char *base_path;
+    const char *partition_label;
+    size_t max_files;
+    bool format_if_mount_failed;
+} esp_vfs_spiffs_conf_t;
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf);
@@ -0,0 +1,26 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name.
+
+// local includes
+#include "esp_err.h"
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO
+} esp_reset_reason_t;
+
+// ESP_RST_POWERON unless hostshim::system::setResetReason() said otherwise
+esp_reset_reason_t esp_reset_reason();
+
+// there is nothing to reboot into, aborts the process
+[[noreturn]] void esp_restart();
@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name.
+
+// system includes
+#include <cstdint>
+
+// us since the process started, on the same clock as the FreeRTOS tick count
+int64_t esp_timer_get_time();
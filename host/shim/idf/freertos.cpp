@@ -0,0 +1,112 @@
+// system includes
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// local includes
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+struct HostTask
+{
+    explicit HostTask(const char *name) : name{name} {}
+
+    const char *name;
+    std::mutex mutex;
+    std::condition_variable notified;
+    uint32_t notifications{};
+};
+
+namespace {
+
+thread_local HostTask *currentTask{};
+
+constexpr int64_t TICK_US = 1000000 / configTICK_RATE_HZ;
+
+void sleepUntilTick(const TickType_t tick)
+{
+    const auto remaining = int32_t(tick - xTaskGetTickCount());
+    if (remaining > 0) std::this_thread::sleep_for(std::chrono::microseconds{remaining * TICK_US});
+}
+
+} // namespace
+
+BaseType_t xTaskCreatePinnedToCore(const TaskFunction_t code, const char *name, uint32_t, void *parameters,
+                                   UBaseType_t, TaskHandle_t *createdTask, BaseType_t)
+{
+    // tasks never end, neither does their handle
+    auto *task = new HostTask{name};
+    if (createdTask) *createdTask = task;
+
+    std::thread{[task, code, parameters] {
+        currentTask = task;
+        code(parameters);
+    }}.detach();
+
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    // threads that were not created through xTaskCreatePinnedToCore(), like main(), get a handle on first use
+    if (!currentTask) currentTask = new HostTask{"main"};
+    return currentTask;
+}
+
+BaseType_t xPortGetCoreID()
+{
+    return 0;
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return TickType_t(esp_timer_get_time() / TICK_US);
+}
+
+void vTaskDelay(const TickType_t ticks)
+{
+    if (ticks)
+        sleepUntilTick(xTaskGetTickCount() + ticks);
+    else
+        std::this_thread::yield();
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *previousWakeTime, const TickType_t increment)
+{
+    const TickType_t wake = *previousWakeTime + increment;
+    const bool delayed = int32_t(wake - xTaskGetTickCount()) > 0;
+
+    sleepUntilTick(wake);
+    *previousWakeTime = wake;
+
+    return delayed ? pdTRUE : pdFALSE;
+}
+
+void xTaskNotifyGive(const TaskHandle_t task)
+{
+    {
+        std::lock_guard lock{task->mutex};
+        ++task->notifications;
+    }
+    task->notified.notify_one();
+}
+
+uint32_t ulTaskNotifyTake(const BaseType_t clearCountOnExit, const TickType_t ticksToWait)
+{
+    auto &task = *xTaskGetCurrentTaskHandle();
+
+    std::unique_lock lock{task.mutex};
+
+    const auto pending = [&task] { return task.notifications != 0; };
+    if (ticksToWait == portMAX_DELAY)
+        task.notified.wait(lock, pending);
+    else
+        task.notified.wait_for(lock, std::chrono::microseconds{int64_t{ticksToWait} * TICK_US}, pending);
+
+    const auto count = task.notifications;
+    if (count) task.notifications = clearCountOnExit ? 0 : count - 1;
+    return count;
+}
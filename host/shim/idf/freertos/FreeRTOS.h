@@ -0,0 +1,24 @@
+#pragma once
+
+// Host stand-in for the FreeRTOS header of the same name, with a 1 kHz tick like the firmware.
+
+// system includes
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY TickType_t(0xFFFFFFFF)
+#define portNUM_PROCESSORS 2
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#define pdMS_TO_TICKS(ms) (TickType_t(uint64_t(ms) * configTICK_RATE_HZ / 1000))
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
@@ -0,0 +1,50 @@
+#pragma once
+
+// Controls for the host stand-ins of ESP-IDF and FreeRTOS, only for the host tests and tools.
+
+// system includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// local includes
+#include "driver/twai.h"
+#include "esp_system.h"
+
+namespace hostshim {
+
+namespace twai {
+    // frame from another node on the bus. It goes through the acceptance filter and the RX queue of the installed
+    // driver, false if the driver is not running, the filter rejected it or the queue was full.
+    bool receive(const twai_message_t &message);
+
+    // frames the firmware transmitted since the last call, oldest first
+    std::vector<twai_message_t> transmitted();
+
+    // a running controller goes bus off and raises TWAI_ALERT_BUS_OFF, TX and RX stop
+    void busOff();
+
+    // ends an initiated recovery like 128 recessive bit sequences would: TWAI_STATE_RECOVERING ->
+    // TWAI_STATE_STOPPED and TWAI_ALERT_BUS_RECOVERED
+    void recover();
+
+    // raised alerts show up in twai_read_alerts() if they are enabled
+    void raiseAlerts(uint32_t alerts);
+
+    bool installed();
+    twai_state_t state();
+
+    // twai_driver_install() calls that succeeded since the process started
+    uint32_t installCount();
+} // namespace twai
+
+namespace system {
+    void setResetReason(esp_reset_reason_t reason);
+} // namespace system
+
+namespace nvs {
+    // number of keys stored in a namespace
+    size_t keys(const char *namespace_name);
+} // namespace nvs
+
+} // namespace hostshim
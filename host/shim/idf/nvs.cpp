@@ -0,0 +1,194 @@
+// system includes
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// local includes
+#include "hostshim.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+
+namespace {
+
+using Namespace = std::map<std::string, std::vector<uint8_t>>;
+
+struct Handle
+{
+    std::string namespaceName;
+    nvs_open_mode_t mode;
+};
+
+struct Storage
+{
+    std::mutex mutex;
+    bool initialized{};
+    std::map<std::string, Namespace> namespaces;
+    std::map<nvs_handle_t, Handle> handles;
+    nvs_handle_t nextHandle{1};
+};
+
+// never destroyed, detached tasks may still write configs while the process exits
+Storage &storage()
+{
+    static auto &instance = *new Storage;
+    return instance;
+}
+
+bool validKey(const char *key)
+{
+    return key && *key && std::strlen(key) < NVS_KEY_NAME_MAX_SIZE;
+}
+
+// locked storage() only
+Namespace *find(Storage &s, const nvs_handle_t handle, const bool write, esp_err_t &err)
+{
+    const auto iter = s.handles.find(handle);
+    if (iter == s.handles.end())
+    {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+        return nullptr;
+    }
+    if (write && iter->second.mode == NVS_READONLY)
+    {
+        err = ESP_ERR_NVS_READ_ONLY;
+        return nullptr;
+    }
+    err = ESP_OK;
+    return &s.namespaces[iter->second.namespaceName];
+}
+
+} // namespace
+
+esp_err_t nvs_flash_init()
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    s.initialized = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase()
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    s.namespaces.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *namespace_name, const nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    if (!s.initialized) return ESP_ERR_NVS_NOT_INITIALIZED;
+    if (!validKey(namespace_name) || !out_handle) return ESP_ERR_INVALID_ARG;
+    if (open_mode == NVS_READONLY && !s.namespaces.contains(namespace_name)) return ESP_ERR_NVS_NOT_FOUND;
+
+    s.namespaces[namespace_name];
+    *out_handle = s.nextHandle++;
+    s.handles[*out_handle] = {namespace_name, open_mode};
+
+    return ESP_OK;
+}
+
+void nvs_close(const nvs_handle_t handle)
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    s.handles.erase(handle);
+}
+
+esp_err_t nvs_commit(const nvs_handle_t handle)
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    return s.handles.contains(handle) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_set_blob(const nvs_handle_t handle, const char *key, const void *value, const size_t length)
+{
+    if (!validKey(key)) return ESP_ERR_NVS_KEY_TOO_LONG;
+
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    esp_err_t err;
+    auto *keys = find(s, handle, true, err);
+    if (!keys) return err;
+
+    const auto *bytes = static_cast<const uint8_t *>(value);
+    (*keys)[key].assign(bytes, bytes + length);
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(const nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    if (!validKey(key) || !length) return ESP_ERR_INVALID_ARG;
+
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    esp_err_t err;
+    auto *keys = find(s, handle, false, err);
+    if (!keys) return err;
+
+    const auto iter = keys->find(key);
+    if (iter == keys->end()) return ESP_ERR_NVS_NOT_FOUND;
+
+    const auto &blob = iter->second;
+    if (out_value)
+    {
+        if (*length < blob.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+        std::memcpy(out_value, blob.data(), blob.size());
+    }
+    *length = blob.size();
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(const nvs_handle_t handle, const char *key)
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    esp_err_t err;
+    auto *keys = find(s, handle, true, err);
+    if (!keys) return err;
+
+    return keys->erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(const nvs_handle_t handle)
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    esp_err_t err;
+    auto *keys = find(s, handle, true, err);
+    if (!keys) return err;
+
+    keys->clear();
+
+    return ESP_OK;
+}
+
+namespace hostshim::nvs {
+
+size_t keys(const char *namespace_name)
+{
+    auto &s = storage();
+    std::lock_guard lock{s.mutex};
+
+    const auto iter = s.namespaces.find(namespace_name);
+    return iter != s.namespaces.end() ? iter->second.size() : 0;
+}
+
+} // namespace hostshim::nvs
@@ -0,0 +1,10 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF header of the same name.
+
+// local includes
+#include "nvs.h"
+
+esp_err_t nvs_flash_init();
+// drops every namespace
+esp_err_t nvs_flash_erase();
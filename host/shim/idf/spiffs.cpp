@@ -0,0 +1,65 @@
+// system includes
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+
+// local includes
+#include "esp_spiffs.h"
+
+// the shim is linked with --wrap=fopen, so every fopen() of the firmware comes through here first
+extern "C" FILE *__real_fopen(const char *path, const char *mode);
+
+namespace {
+
+struct Mount
+{
+    std::mutex mutex;
+    std::string basePath;
+    std::string directory;
+};
+
+// immortal, firmware tasks may still open files while the process exits
+Mount &mount()
+{
+    static auto *mount = new Mount;
+    return *mount;
+}
+
+} // namespace
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t *conf)
+{
+    if (!conf || !conf->base_path) return ESP_ERR_INVALID_ARG;
+
+    auto &m = mount();
+    std::lock_guard lock{m.mutex};
+
+    if (!m.basePath.empty()) return ESP_ERR_INVALID_STATE;
+
+    std::string directory = conf->partition_label ? conf->partition_label : "spiffs";
+    if (::mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) return ESP_FAIL;
+
+    m.basePath = conf->base_path;
+    m.directory = std::move(directory);
+    return ESP_OK;
+}
+
+extern "C" FILE *__wrap_fopen(const char *path, const char *mode)
+{
+    auto &m = mount();
+    std::unique_lock lock{m.mutex};
+
+    const auto length = m.basePath.size();
+    if (length && std::strncmp(path, m.basePath.c_str(), length) == 0 && path[length] == '/')
+    {
+        const auto hostPath = m.directory + (path + length);
+        lock.unlock();
+        return __real_fopen(hostPath.c_str(), mode);
+    }
+
+    lock.unlock();
+    return __real_fopen(path, mode);
+}
@@ -0,0 +1,379 @@
+// system includes
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// local includes
+#include "driver/twai.h"
+#include "hostshim.h"
+
+namespace {
+
+struct Driver
+{
+    std::mutex mutex;
+    std::condition_variable rxReady;
+    std::condition_variable alertRaised;
+
+    bool installed{};
+    twai_state_t state{TWAI_STATE_STOPPED};
+    twai_general_config_t general{};
+    twai_filter_config_t filter{};
+
+    std::deque<twai_message_t> rx;
+    std::vector<twai_message_t> tx;
+    uint32_t pendingAlerts{};
+
+    uint32_t receivers{}; // tasks waiting in twai_receive()
+    uint32_t rxMissed{};
+    uint32_t installCount{};
+};
+
+// never destroyed, detached tasks may still wait on it while the process exits
+Driver &driver()
+{
+    static auto &instance = *new Driver;
+    return instance;
+}
+
+std::chrono::microseconds ticks(const TickType_t ticks)
+{
+    return std::chrono::microseconds{int64_t{ticks} * 1000000 / configTICK_RATE_HZ};
+}
+
+template<typename Predicate>
+bool waitFor(std::condition_variable &condition, std::unique_lock<std::mutex> &lock, const TickType_t timeout,
+             Predicate &&predicate)
+{
+    if (timeout == portMAX_DELAY)
+    {
+        condition.wait(lock, predicate);
+        return true;
+    }
+    return condition.wait_for(lock, ticks(timeout), predicate);
+}
+
+void raise(Driver &d, const uint32_t alerts)
+{
+    d.pendingAlerts |= alerts;
+    if (d.pendingAlerts & d.general.alerts_enabled) d.alertRaised.notify_all();
+}
+
+bool matches(const uint32_t value, const uint32_t code, const uint32_t mask, const uint32_t compared)
+{
+    return ((value ^ code) & ~mask & compared) == 0;
+}
+
+// see "Acceptance Filter" in the TWAI driver documentation for the bit layouts
+bool accepted(const twai_filter_config_t &filter, const twai_message_t &message)
+{
+    const uint32_t rtr = message.rtr;
+    const uint32_t data0 = message.data_length_code > 0 ? message.data[0] : 0;
+    const uint32_t data1 = message.data_length_code > 1 ? message.data[1] : 0;
+    const auto code = filter.acceptance_code;
+    const auto mask = filter.acceptance_mask;
+
+    if (message.extd)
+    {
+        if (filter.single_filter) return matches(message.identifier << 3 | rtr << 2, code, mask, 0xFFFFFFFC);
+
+        const uint32_t upper = message.identifier >> 13;
+        return matches(upper << 16, code, mask, 0xFFFF0000) || matches(upper, code, mask, 0x0000FFFF);
+    }
+
+    if (filter.single_filter)
+        return matches(message.identifier << 21 | rtr << 20 | data0 << 8 | data1, code, mask, 0xFFF0FFFF);
+
+    const uint32_t first = message.identifier << 21 | rtr << 20 | (data0 >> 4) << 16 | (data0 & 0x0F);
+    const uint32_t second = message.identifier << 5 | rtr << 4;
+    return matches(first, code, mask, 0xFFFF000F) || matches(second, code, mask, 0x0000FFF0);
+}
+
+} // namespace
+
+esp_err_t twai_driver_install(const twai_general_config_t *g_config, const twai_timing_config_t *t_config,
+                              const twai_filter_config_t *f_config)
+{
+    if (!g_config || !t_config || !f_config || !g_config->rx_queue_len) return ESP_ERR_INVALID_ARG;
+
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (d.installed) return ESP_ERR_INVALID_STATE;
+
+    d.installed = true;
+    d.state = TWAI_STATE_STOPPED;
+    d.general = *g_config;
+    d.filter = *f_config;
+    d.rx.clear();
+    d.pendingAlerts = 0;
+    d.rxMissed = 0;
+    ++d.installCount;
+
+    return ESP_OK;
+}
+
+esp_err_t twai_driver_uninstall()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed || (d.state != TWAI_STATE_STOPPED && d.state != TWAI_STATE_BUS_OFF)) return ESP_ERR_INVALID_STATE;
+
+    // the real driver frees the queue a waiting task blocks on
+    if (d.receivers)
+    {
+        std::fprintf(stderr, "twai_driver_uninstall() while a task waits in twai_receive()\n");
+        std::abort();
+    }
+
+    d.installed = false;
+    d.rx.clear();
+    d.pendingAlerts = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t twai_start()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed || d.state != TWAI_STATE_STOPPED) return ESP_ERR_INVALID_STATE;
+
+    d.state = TWAI_STATE_RUNNING;
+    d.rx.clear();
+
+    return ESP_OK;
+}
+
+esp_err_t twai_stop()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed || d.state != TWAI_STATE_RUNNING) return ESP_ERR_INVALID_STATE;
+
+    d.state = TWAI_STATE_STOPPED;
+
+    return ESP_OK;
+}
+
+esp_err_t twai_transmit(const twai_message_t *message, TickType_t)
+{
+    if (!message || message->data_length_code > TWAI_FRAME_MAX_DLC) return ESP_ERR_INVALID_ARG;
+
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed || d.state != TWAI_STATE_RUNNING) return ESP_ERR_INVALID_STATE;
+    if (d.general.mode == TWAI_MODE_LISTEN_ONLY) return ESP_ERR_NOT_SUPPORTED;
+
+    // the bus is always free, every frame goes out right away
+    d.tx.push_back(*message);
+    raise(d, TWAI_ALERT_TX_SUCCESS | TWAI_ALERT_TX_IDLE);
+
+    return ESP_OK;
+}
+
+esp_err_t twai_receive(twai_message_t *message, const TickType_t ticks_to_wait)
+{
+    if (!message) return ESP_ERR_INVALID_ARG;
+
+    auto &d = driver();
+    std::unique_lock lock{d.mutex};
+
+    if (!d.installed) return ESP_ERR_INVALID_STATE;
+
+    ++d.receivers;
+    const bool received = waitFor(d.rxReady, lock, ticks_to_wait, [&d] { return !d.rx.empty(); });
+    --d.receivers;
+
+    if (!received) return ESP_ERR_TIMEOUT;
+
+    *message = d.rx.front();
+    d.rx.pop_front();
+
+    return ESP_OK;
+}
+
+esp_err_t twai_read_alerts(uint32_t *alerts, const TickType_t ticks_to_wait)
+{
+    if (!alerts) return ESP_ERR_INVALID_ARG;
+
+    auto &d = driver();
+    std::unique_lock lock{d.mutex};
+
+    if (!d.installed) return ESP_ERR_INVALID_STATE;
+
+    const auto raised = [&d] { return (d.pendingAlerts & d.general.alerts_enabled) != 0; };
+    if (!waitFor(d.alertRaised, lock, ticks_to_wait, raised))
+    {
+        *alerts = 0;
+        return ESP_ERR_TIMEOUT;
+    }
+
+    *alerts = d.pendingAlerts & d.general.alerts_enabled;
+    d.pendingAlerts = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t twai_reconfigure_alerts(const uint32_t alerts_enabled, uint32_t *current_alerts)
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed) return ESP_ERR_INVALID_STATE;
+
+    if (current_alerts) *current_alerts = d.pendingAlerts & d.general.alerts_enabled;
+    d.general.alerts_enabled = alerts_enabled;
+    d.pendingAlerts = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t twai_initiate_recovery()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed || d.state != TWAI_STATE_BUS_OFF) return ESP_ERR_INVALID_STATE;
+
+    d.state = TWAI_STATE_RECOVERING;
+    raise(d, TWAI_ALERT_RECOVERY_IN_PROGRESS);
+
+    return ESP_OK;
+}
+
+esp_err_t twai_get_status_info(twai_status_info_t *status_info)
+{
+    if (!status_info) return ESP_ERR_INVALID_ARG;
+
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed) return ESP_ERR_INVALID_STATE;
+
+    *status_info = {};
+    status_info->state = d.state;
+    status_info->msgs_to_rx = d.rx.size();
+    status_info->rx_missed_count = d.rxMissed;
+
+    return ESP_OK;
+}
+
+esp_err_t twai_clear_transmit_queue()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    return d.installed ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t twai_clear_receive_queue()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed) return ESP_ERR_INVALID_STATE;
+
+    d.rx.clear();
+
+    return ESP_OK;
+}
+
+namespace hostshim::twai {
+
+bool receive(const twai_message_t &message)
+{
+    auto &d = driver();
+    {
+        std::lock_guard lock{d.mutex};
+
+        if (!d.installed || d.state != TWAI_STATE_RUNNING || !accepted(d.filter, message)) return false;
+
+        if (d.rx.size() >= d.general.rx_queue_len)
+        {
+            ++d.rxMissed;
+            raise(d, TWAI_ALERT_RX_QUEUE_FULL);
+            return false;
+        }
+
+        d.rx.push_back(message);
+        raise(d, TWAI_ALERT_RX_DATA);
+    }
+    d.rxReady.notify_one();
+
+    return true;
+}
+
+std::vector<twai_message_t> transmitted()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    std::vector<twai_message_t> result;
+    result.swap(d.tx);
+    return result;
+}
+
+void busOff()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed || d.state != TWAI_STATE_RUNNING) return;
+
+    d.state = TWAI_STATE_BUS_OFF;
+    raise(d, TWAI_ALERT_BUS_OFF);
+}
+
+void recover()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    if (!d.installed || d.state != TWAI_STATE_RECOVERING) return;
+
+    d.state = TWAI_STATE_STOPPED;
+    raise(d, TWAI_ALERT_BUS_RECOVERED);
+}
+
+void raiseAlerts(const uint32_t alerts)
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    raise(d, alerts);
+}
+
+bool installed()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    return d.installed;
+}
+
+twai_state_t state()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    return d.state;
+}
+
+uint32_t installCount()
+{
+    auto &d = driver();
+    std::lock_guard lock{d.mutex};
+
+    return d.installCount;
+}
+
+} // namespace hostshim::twai
@@ -0,0 +1,45 @@
+#pragma once
+
+// Host stand-in for the cpputils header of the same name.
+
+// system includes
+#include <cstddef>
+
+namespace cpputils {
+
+template<typename T>
+class ArrayView
+{
+public:
+    constexpr ArrayView(T *begin, T *end) : m_begin{begin}, m_end{end}
+    {
+    }
+
+    template<size_t N>
+    constexpr ArrayView(T (&array)[N]) : m_begin{array}, m_end{array + N}
+    {
+    }
+
+    constexpr T *begin() const
+    {
+        return m_begin;
+    }
+    constexpr T *end() const
+    {
+        return m_end;
+    }
+    constexpr size_t size() const
+    {
+        return m_end - m_begin;
+    }
+    constexpr T &operator[](const size_t index) const
+    {
+        return m_begin[index];
+    }
+
+private:
+    T *m_begin;
+    T *m_end;
+};
+
+} // namespace cpputils
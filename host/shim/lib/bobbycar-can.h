@@ -0,0 +1,122 @@
+#pragma once
+
+// Host stand-in for the bobbycar-protocol header of the same name, used when the submodule is not checked out. The
+// identifier layout follows the protocol: bits 7-8 the direction, bit 1 front/back, bit 0 left/right and bits 2-6
+// the value.
+
+// system includes
+#include <cstdint>
+
+// local includes
+#include "bobbycar-common.h"
+
+namespace bobbycar::protocol::can {
+
+enum : uint16_t
+{
+    MotorControllerRec = 0b00000000000,
+    MotorControllerSend = 0b00010000000,
+    BoardcomputerRec = 0b00100000000,
+    BoardcomputerSend = 0b00110000000,
+};
+
+enum : uint16_t
+{
+    MotorControllerLeft = 0b00000000000,
+    MotorControllerRight = 0b00000000001,
+};
+
+enum : uint16_t
+{
+    MotorControllerFront = 0b00000000000,
+    MotorControllerBack = 0b00000000010,
+};
+
+template<bool isBack, bool isRight>
+struct MotorController
+{
+    static constexpr uint16_t motor = uint16_t(isBack ? MotorControllerBack : MotorControllerFront) |
+                                      uint16_t(isRight ? MotorControllerRight : MotorControllerLeft);
+
+    struct Command
+    {
+        enum : uint16_t
+        {
+            Enable = MotorControllerRec | motor | 0b00000000000,
+            InpTgt = MotorControllerRec | motor | 0b00000000100,
+            CtrlTyp = MotorControllerRec | motor | 0b00000001000,
+            CtrlMod = MotorControllerRec | motor | 0b00000001100,
+            IMotMax = MotorControllerRec | motor | 0b00000010000,
+            IDcMax = MotorControllerRec | motor | 0b00000010100,
+            NMotMax = MotorControllerRec | motor | 0b00000011000,
+            FieldWeakMax = MotorControllerRec | motor | 0b00000011100,
+            PhaseAdvMax = MotorControllerRec | motor | 0b00000100000,
+            BuzzerFreq = MotorControllerRec | motor | 0b00000100100,
+            BuzzerPattern = MotorControllerRec | motor | 0b00000101000,
+            Led = MotorControllerRec | motor | 0b00000101100,
+            Poweroff = MotorControllerRec | motor | 0b00000110000,
+            CruiseCtrlEna = MotorControllerRec | motor | 0b00000110100,
+            CruiseMotTgt = MotorControllerRec | motor | 0b00000111000,
+        };
+    };
+
+    struct Feedback
+    {
+        enum : uint16_t
+        {
+            DcLink = MotorControllerSend | motor | 0b00000000000,
+            Speed = MotorControllerSend | motor | 0b00000000100,
+            Error = MotorControllerSend | motor | 0b00000001000,
+            Angle = MotorControllerSend | motor | 0b00000001100,
+            DcPhaA = MotorControllerSend | motor | 0b00000010000,
+            DcPhaB = MotorControllerSend | motor | 0b00000010100,
+            DcPhaC = MotorControllerSend | motor | 0b00000011000,
+            Chops = MotorControllerSend | motor | 0b00000011100,
+            Hall = MotorControllerSend | motor | 0b00000100000,
+            Voltage = MotorControllerSend | motor | 0b00000100100,
+            Temp = MotorControllerSend | motor | 0b00000101000,
+            Id = MotorControllerSend | motor | 0b00000101100,
+            Iq = MotorControllerSend | motor | 0b00000110000,
+        };
+    };
+};
+
+namespace Boardcomputer {
+
+enum class Button : uint16_t
+{
+    Left = 1,
+    Right = 2,
+    Up = 4,
+    Down = 8,
+    Profile0 = 16,
+    Profile1 = 32,
+    Profile2 = 64,
+    Profile3 = 128,
+};
+
+struct Command
+{
+    enum : uint16_t
+    {
+        ButtonPress = BoardcomputerRec | 0b00000000000,
+        RawButtonPressed = BoardcomputerRec | 0b00000000100,
+        RawButtonReleased = BoardcomputerRec | 0b00000001000,
+        ButtonPressed = BoardcomputerRec | 0b00000001100,
+        ButtonReleased = BoardcomputerRec | 0b00000010000,
+        RawGas = BoardcomputerRec | 0b00000010100,
+        RawBrems = BoardcomputerRec | 0b00000011000,
+    };
+};
+
+struct Feedback
+{
+    enum : uint16_t
+    {
+        ButtonLeds = BoardcomputerSend | 0b00000000000,
+    };
+};
+
+} // namespace Boardcomputer
+
+} // namespace bobbycar::protocol::can
@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for the bobbycar-protocol header of the same name, used when the submodule is not checked out.
+
+// system includes
+#include <cstdint>
+
+namespace bobbycar::protocol {
+
+enum class ControlType : uint8_t
+{
+    Commutation,
+    Sinusoidal,
+    FieldOrientedControl
+};
+
+enum class ControlMode : uint8_t
+{
+    OpenMode,
+    Voltage,
+    Speed,
+    Torque
+};
+
+} // namespace bobbycar::protocol
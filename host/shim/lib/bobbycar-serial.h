@@ -0,0 +1,69 @@
+#pragma once
+
+// Host stand-in for the bobbycar-protocol header of the same name, used when the submodule is not checked out.
+
+// system includes
+#include <cstdint>
+
+// local includes
+#include "bobbycar-common.h"
+
+namespace bobbycar::protocol::serial {
+
+struct MotorState
+{
+    bool enable = false;
+    int16_t pwm = 0;
+    ControlType ctrlTyp = ControlType::FieldOrientedControl;
+    ControlMode ctrlMod = ControlMode::OpenMode;
+    uint8_t iMotMax = 15;
+    uint8_t iDcMax = 17;
+    uint16_t nMotMax = 1000;
+    uint8_t fieldWeakMax = 10;
+    uint8_t phaseAdvMax = 40;
+    int16_t nCruiseMotTgt = 0;
+    bool cruiseCtrlEna = false;
+};
+
+struct BuzzerState
+{
+    uint8_t freq = 0;
+    uint8_t pattern = 0;
+};
+
+struct Command
+{
+    uint16_t start;
+    MotorState left, right;
+    BuzzerState buzzer;
+    bool poweroff = false;
+    bool led = false;
+    uint16_t checksum;
+};
+
+struct MotorFeedback
+{
+    int16_t angle = 0;
+    int16_t speed = 0;
+    uint8_t error = 0;
+    int16_t dcLink = 0;
+    int16_t dcPhaA = 0;
+    int16_t dcPhaB = 0;
+    int16_t dcPhaC = 0;
+    uint16_t chops = 0;
+    bool hallA = false, hallB = false, hallC = false;
+    int16_t id = 0;
+    int16_t iq = 0;
+};
+
+struct Feedback
+{
+    uint16_t start;
+    MotorFeedback left, right;
+    int16_t batVoltage = 0;
+    int16_t boardTemp = 0;
+    int16_t timeoutCntSerial = 0;
+    uint16_t checksum;
+};
+
+} // namespace bobbycar::protocol::serial
@@ -0,0 +1,35 @@
+#pragma once
+
+// Host stand-in for the espconfiglib header of the same name.
+
+// system includes
+#include <expected>
+#include <string>
+
+namespace espconfig {
+
+// empty on success, the reason otherwise
+using ConfigConstraintReturnType = std::expected<void, std::string>;
+
+template<typename T, T MIN>
+ConfigConstraintReturnType MinValue(const T value)
+{
+    if (value < MIN) return std::unexpected("value " + std::to_string(value) + " is below " + std::to_string(MIN));
+    return {};
+}
+
+template<typename T, T MAX>
+ConfigConstraintReturnType MaxValue(const T value)
+{
+    if (value > MAX) return std::unexpected("value " + std::to_string(value) + " is above " + std::to_string(MAX));
+    return {};
+}
+
+template<typename T, T MIN, T MAX>
+ConfigConstraintReturnType MinMaxValue(const T value)
+{
+    if (const auto result = MinValue<T, MIN>(value); !result) return result;
+    return MaxValue<T, MAX>(value);
+}
+
+} // namespace espconfig
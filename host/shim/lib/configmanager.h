@@ -0,0 +1,79 @@
+#pragma once
+
+// Host stand-in for espconfiglib. Values are kept as blobs in the in-memory NVS of the host shim, the members that
+// are not templated on the value type are defined in configwrapper_priv.h and configmanager_priv.h and instantiated
+// through the same macros as with the real library.
+
+// system includes
+#include <expected>
+#include <optional>
+#include <string>
+
+// esp-idf includes
+#include <esp_err.h>
+#include <nvs.h>
+
+// 3rdparty lib includes
+#include <configconstraints_base.h>
+#include <cppmacros.h>
+
+namespace espconfig {
+
+class ConfigWrapperInterface
+{
+public:
+    virtual ~ConfigWrapperInterface() = default;
+
+    virtual const char *nvsName() const = 0;
+    virtual bool allowReset() const = 0;
+
+    // keeps the default if there is no valid stored value
+    virtual esp_err_t loadFromFlash(nvs_handle_t handle) = 0;
+    virtual std::expected<void, std::string> loadDefault(nvs_handle_t handle) = 0;
+};
+
+template<typename T>
+class ConfigWrapper : public ConfigWrapperInterface
+{
+public:
+    using value_t = T;
+    using ConstraintCallback = ConfigConstraintReturnType (*)(value_t);
+
+    ConfigWrapper() = default;
+    CPP_DISABLE_COPY_MOVE(ConfigWrapper)
+
+    virtual value_t defaultValue() const = 0;
+    virtual ConfigConstraintReturnType checkValue(value_t value) const = 0;
+
+    // configs that were never loaded, because no callForEveryConfig() lists them, read as their default
+    const value_t &value() const;
+
+    std::expected<void, std::string> write(nvs_handle_t handle, value_t value);
+
+    esp_err_t loadFromFlash(nvs_handle_t handle) override;
+    std::expected<void, std::string> loadDefault(nvs_handle_t handle) override;
+
+private:
+    mutable std::optional<value_t> m_value;
+};
+
+template<typename T>
+class ConfigManager : public T
+{
+public:
+    // opens the namespace and loads every config that callForEveryConfig() lists
+    esp_err_t init(const char *ns);
+
+    // writes the default of every config that allows it
+    std::expected<void, std::string> reset();
+
+    template<typename U>
+    std::expected<void, std::string> write_config(ConfigWrapper<U> &config, const U value)
+    {
+        return config.write(nvs_handle_user, value);
+    }
+
+    nvs_handle_t nvs_handle_user{};
+};
+
+} // namespace espconfig
@@ -0,0 +1,54 @@
+#pragma once
+
+// Host stand-in for the espconfiglib header of the same name, included by the translation unit that defines the
+// ConfigManager.
+
+// esp-idf includes
+#include <esp_log.h>
+#include <nvs.h>
+#include <nvs_flash.h>
+
+// 3rdparty lib includes
+#include <configmanager.h>
+
+namespace {
+constexpr const char *const TAG = "CONFIG";
+} // namespace
+
+namespace espconfig {
+
+template<typename T>
+esp_err_t ConfigManager<T>::init(const char *ns)
+{
+    if (const auto err = nvs_flash_init(); err != ESP_OK) return err;
+    if (const auto err = nvs_open(ns, NVS_READWRITE, &nvs_handle_user); err != ESP_OK) return err;
+
+    esp_err_t result{ESP_OK};
+    T::callForEveryConfig([this, &result](ConfigWrapperInterface &config) {
+        if (const auto err = config.loadFromFlash(nvs_handle_user); err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "loading %s failed with %s", config.nvsName(), esp_err_to_name(err));
+            result = err;
+        }
+        return false;
+    });
+    return result;
+}
+
+template<typename T>
+std::expected<void, std::string> ConfigManager<T>::reset()
+{
+    std::expected<void, std::string> result;
+    T::callForEveryConfig([this, &result](ConfigWrapperInterface &config) {
+        if (!config.allowReset()) return false;
+
+        if (auto loaded = config.loadDefault(nvs_handle_user); !loaded && result)
+            result = std::unexpected(std::string{config.nvsName()} + ": " + std::move(loaded).error());
+        return false;
+    });
+    return result;
+}
+
+} // namespace espconfig
+
+#define INSTANTIATE_CONFIGMANAGER_TEMPLATES(Type) template class espconfig::ConfigManager<Type>;
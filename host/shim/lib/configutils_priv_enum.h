@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in for the espconfiglib header of the same name. The host stand-in stores every value as a blob, enums
+// need no NVS accessors of their own.
+
+// system includes
+#include <type_traits>
+
+#define IMPLEMENT_NVS_GET_SET_ENUM(Name) static_assert(std::is_enum_v<Name>, #Name " is not an enum");
@@ -0,0 +1,20 @@
+// Instantiates the stand-in ConfigWrapper for the value types the real library covers itself, main/ adds its enums
+// in configwrapper_bobby.cpp.
+
+// system includes
+#include <cstdint>
+
+// 3rdparty lib includes
+#include <configwrapper_priv.h>
+
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(bool)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(int8_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(uint8_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(int16_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(uint16_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(int32_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(uint32_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(int64_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(uint64_t)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(float)
+INSTANTIATE_CONFIGWRAPPER_TEMPLATES(double)
@@ -0,0 +1,69 @@
+#pragma once
+
+// Host stand-in for the espconfiglib header of the same name, included once per value type to instantiate it.
+
+// system includes
+#include <type_traits>
+
+// esp-idf includes
+#include <esp_log.h>
+#include <nvs.h>
+
+// 3rdparty lib includes
+#include <configmanager.h>
+
+namespace espconfig {
+
+template<typename T>
+const T &ConfigWrapper<T>::value() const
+{
+    if (!m_value) m_value = defaultValue();
+    return *m_value;
+}
+
+template<typename T>
+std::expected<void, std::string> ConfigWrapper<T>::write(const nvs_handle_t handle, const value_t value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "the host stand-in stores values as blobs");
+
+    if (auto result = checkValue(value); !result) return std::unexpected(std::move(result).error());
+
+    if (const auto err = nvs_set_blob(handle, nvsName(), &value, sizeof(value)); err != ESP_OK)
+        return std::unexpected(std::string{"nvs_set_blob() failed with "} + esp_err_to_name(err));
+
+    m_value = value;
+    return {};
+}
+
+template<typename T>
+esp_err_t ConfigWrapper<T>::loadFromFlash(const nvs_handle_t handle)
+{
+    value_t stored;
+    size_t length{sizeof(stored)};
+
+    if (const auto err = nvs_get_blob(handle, nvsName(), &stored, &length); err != ESP_OK)
+    {
+        m_value = defaultValue();
+        return err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+    }
+
+    if (length != sizeof(stored) || !checkValue(stored))
+    {
+        ESP_LOGW("CONFIG", "invalid stored value for %s, using the default", nvsName());
+        m_value = defaultValue();
+        return ESP_OK;
+    }
+
+    m_value = stored;
+    return ESP_OK;
+}
+
+template<typename T>
+std::expected<void, std::string> ConfigWrapper<T>::loadDefault(const nvs_handle_t handle)
+{
+    return write(handle, defaultValue());
+}
+
+} // namespace espconfig
+
+#define INSTANTIATE_CONFIGWRAPPER_TEMPLATES(Type) template class espconfig::ConfigWrapper<Type>;
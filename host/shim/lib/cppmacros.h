@@ -0,0 +1,15 @@
+#pragma once
+
+// Host stand-in for the cpputils header of the same name.
+
+#define CPP_DISABLE_COPY(Class)                                                                                        \
+    Class(const Class &) = delete;                                                                                     \
+    Class &operator=(const Class &) = delete;
+
+#define CPP_DISABLE_MOVE(Class)                                                                                        \
+    Class(Class &&) = delete;                                                                                          \
+    Class &operator=(Class &&) = delete;
+
+#define CPP_DISABLE_COPY_MOVE(Class)                                                                                   \
+    CPP_DISABLE_COPY(Class)                                                                                            \
+    CPP_DISABLE_MOVE(Class)
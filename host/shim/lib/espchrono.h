@@ -0,0 +1,53 @@
+#pragma once
+
+// Host stand-in for espchrono, only the clocks main/ uses. Both run on esp_timer_get_time() like on the ESP32.
+
+// system includes
+#include <chrono>
+#include <cstdint>
+
+// esp-idf includes
+#include <esp_timer.h>
+
+namespace espchrono {
+
+using milliseconds32 = std::chrono::duration<int32_t, std::milli>;
+using seconds32 = std::chrono::duration<int32_t>;
+
+struct millis_clock
+{
+    using rep = int64_t;
+    using period = std::milli;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<millis_clock>;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+        return time_point{duration{esp_timer_get_time() / 1000}};
+    }
+};
+
+struct micros_clock
+{
+    using rep = int64_t;
+    using period = std::micro;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<micros_clock>;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+        return time_point{duration{esp_timer_get_time()}};
+    }
+};
+
+template<typename Clock, typename Duration>
+typename Clock::duration ago(const std::chrono::time_point<Clock, Duration> &timePoint)
+{
+    return Clock::now() - timePoint;
+}
+
+} // namespace espchrono
@@ -0,0 +1,87 @@
+#pragma once
+
+// Host stand-in for the espcpputils header of the same name.
+
+// system includes
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+// esp-idf includes
+#include <esp_log.h>
+#include <esp_timer.h>
+
+// 3rdparty lib includes
+#include <espchrono.h>
+
+namespace espcpputils {
+
+class SchedulerTask
+{
+public:
+    SchedulerTask(const char *name, void (&setupCallback)(), void (&loopCallback)(),
+                  espchrono::millis_clock::duration loopInterval, bool intervalImportant = false,
+                  std::string (*perfInfo)() = nullptr) :
+        m_name{name}, m_setupCallback{setupCallback}, m_loopCallback{loopCallback}, m_loopInterval{loopInterval},
+        m_intervalImportant{intervalImportant}, m_perfInfo{perfInfo}
+    {
+    }
+
+    const char *name() const
+    {
+        return m_name;
+    }
+
+    void setup()
+    {
+        m_setupCallback();
+    }
+
+    void loop()
+    {
+        const auto start = esp_timer_get_time();
+        m_loopCallback();
+        const auto elapsed = esp_timer_get_time() - start;
+
+        ++m_callCount;
+        m_totalElapsed += elapsed;
+        m_maxElapsed = std::max(m_maxElapsed, elapsed);
+    }
+
+    // averages since the last call
+    void pushStats(const bool printTask)
+    {
+        if (printTask)
+            ESP_LOGI("SchedulerTask", "%s: %u calls, avg %lldus, max %lldus%s%s", m_name, unsigned(m_callCount),
+                     m_callCount ? m_totalElapsed / m_callCount : 0, m_maxElapsed, m_perfInfo ? ", " : "",
+                     m_perfInfo ? m_perfInfo().c_str() : "");
+
+        m_callCount = 0;
+        m_totalElapsed = 0;
+        m_maxElapsed = 0;
+    }
+
+    espchrono::millis_clock::duration loopInterval() const
+    {
+        return m_loopInterval;
+    }
+
+    bool intervalImportant() const
+    {
+        return m_intervalImportant;
+    }
+
+private:
+    const char *m_name;
+    void (&m_setupCallback)();
+    void (&m_loopCallback)();
+    const espchrono::millis_clock::duration m_loopInterval;
+    const bool m_intervalImportant;
+    std::string (*m_perfInfo)();
+
+    uint32_t m_callCount{};
+    int64_t m_totalElapsed{};
+    int64_t m_maxElapsed{};
+};
+
+} // namespace espcpputils
@@ -0,0 +1,21 @@
+#pragma once
+
+// Host stand-in for the espcpputils header of the same name.
+
+// system includes
+#include <chrono>
+
+// esp-idf includes
+#include <freertos/FreeRTOS.h>
+
+namespace espcpputils {
+
+using ticks = std::chrono::duration<TickType_t, std::ratio<1, configTICK_RATE_HZ>>;
+
+template<typename Rep, typename Period>
+constexpr TickType_t toTicks(const std::chrono::duration<Rep, Period> &duration)
+{
+    return std::chrono::ceil<ticks>(duration).count();
+}
+
+} // namespace espcpputils
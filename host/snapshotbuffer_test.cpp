@@ -0,0 +1,51 @@
+// system includes
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// local includes
+#include "hostcheck.h"
+#include "utils/snapshotbuffer.h"
+
+namespace {
+struct Pair
+{
+    std::array<uint32_t, 16> values;
+};
+} // namespace
+
+int main()
+{
+    SnapshotBuffer<Pair> buffer;
+
+    uint32_t generation = buffer.generation();
+    Pair copy{};
+    HOST_CHECK(!buffer.readIfChanged(copy, generation));
+
+    Pair value{};
+    value.values.fill(7);
+    buffer.publish(value);
+    HOST_CHECK(buffer.readIfChanged(copy, generation));
+    HOST_CHECK(copy.values[15] == 7);
+    HOST_CHECK(buffer.read([](const Pair &pair) { return pair.values[0]; }) == 7);
+
+    // a reader running next to the writer must never see a half written value
+    std::atomic<bool> done{false};
+    std::thread writer{[&] {
+        Pair next{};
+        for (uint32_t i = 0; i < 20000; ++i)
+        {
+            next.values.fill(i);
+            buffer.publish(next);
+        }
+        done = true;
+    }};
+
+    while (!done)
+    {
+        buffer.read(copy);
+        for (const auto entry: copy.values) HOST_CHECK(entry == copy.values[0]);
+    }
+    writer.join();
+}
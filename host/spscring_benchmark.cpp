@@ -0,0 +1,107 @@
+// Throughput and hand-off latency of the ring between the CAN RX task and the CAN task, with a payload the size of
+// the RX task's frames, and the cost of a single push() while the consumer drains concurrently, which is what the RX
+// task pays per frame. Not part of ctest, run it on an idle machine:
+//   ./spscring_benchmark
+
+// system includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+// local includes
+#include "utils/loghistogram.h"
+#include "utils/spscring.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// same layout as RxFrame in can.cpp: timestamp plus twai_message_t
+struct Frame
+{
+    int64_t timestamp;
+    uint32_t flags;
+    uint32_t identifier;
+    uint8_t length;
+    uint8_t data[8];
+};
+
+constexpr uint32_t FRAMES = 2000000;
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void singleThread()
+{
+    SpscRing<Frame, 64> ring;
+    Frame frame{};
+
+    const auto start = nowNs();
+    for (uint32_t i = 0; i < FRAMES; ++i)
+    {
+        frame.identifier = i;
+        ring.push(frame);
+        ring.pop(frame);
+    }
+    const auto elapsed = nowNs() - start;
+
+    std::printf("single thread push+pop: %.1f ns\n", double(elapsed) / FRAMES);
+}
+
+void handOff()
+{
+    SpscRing<Frame, 64> ring;
+    LogHistogram<> latencyNs;
+    LogHistogram<> pushNs; // every push() call on its own, failed ones included
+    uint32_t full{};
+
+    std::atomic<bool> done{false};
+    std::thread producer{[&] {
+        Frame frame{};
+        for (uint32_t i = 0; i < FRAMES; ++i)
+        {
+            frame.identifier = i;
+            frame.timestamp = nowNs();
+            while (true)
+            {
+                const auto before = nowNs();
+                const bool pushed = ring.push(frame);
+                pushNs.record(uint32_t(nowNs() - before));
+                if (pushed) break;
+
+                ++full;
+                std::this_thread::yield();
+            }
+        }
+        done = true;
+    }};
+
+    const auto start = nowNs();
+    Frame frame;
+    while (!done || ring.size())
+    {
+        if (ring.pop(frame))
+            latencyNs.record(uint32_t(nowNs() - frame.timestamp));
+        else
+            std::this_thread::yield();
+    }
+    const auto elapsed = nowNs() - start;
+    producer.join();
+
+    std::printf("hand-off: %u frames in %.1f ms, producer found the ring full %u times\n", latencyNs.count(),
+                elapsed / 1e6, full);
+    std::printf("hand-off latency: p50 <= %u ns, p99 <= %u ns, max %u ns\n", latencyNs.percentile(50),
+                latencyNs.percentile(99), latencyNs.max());
+    std::printf("push(), including one clock read: p50 <= %u ns, p99 <= %u ns, max %u ns\n", pushNs.percentile(50),
+                pushNs.percentile(99), pushNs.max());
+}
+} // namespace
+
+int main()
+{
+    singleThread();
+    handOff();
+}
@@ -0,0 +1,50 @@
+// system includes
+#include <cstdint>
+#include <thread>
+
+// local includes
+#include "hostcheck.h"
+#include "utils/spscring.h"
+
+int main()
+{
+    SpscRing<uint32_t, 4> ring;
+    uint32_t value{};
+    HOST_CHECK(!ring.pop(value));
+
+    for (uint32_t i = 0; i < 4; ++i) HOST_CHECK(ring.push(i));
+    HOST_CHECK(!ring.push(4));
+    HOST_CHECK(ring.size() == 4);
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        HOST_CHECK(ring.pop(value));
+        HOST_CHECK(value == i);
+    }
+    HOST_CHECK(!ring.pop(value));
+
+    // one producer and one consumer thread, every value arrives once and in order
+    constexpr uint32_t total = 100000;
+    SpscRing<uint32_t, 64> shared;
+    std::thread producer{[&] {
+        for (uint32_t i = 0; i < total;)
+        {
+            if (shared.push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    }};
+
+    for (uint32_t expected = 0; expected < total;)
+    {
+        if (!shared.pop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        HOST_CHECK(value == expected);
+        ++expected;
+    }
+    producer.join();
+}
@@ -0,0 +1,49 @@
+// TempomatMode on the firmware build: the brake pedal slows the setpoint down to standstill but never into reverse,
+// and a hard brake press lets go of the setpoint and brakes like OriginalMode.
+
+// local includes
+#include "driving_modes/tempomat.h"
+#include "firmwarebus.h"
+
+using namespace firmwarebus;
+
+int main()
+{
+    boot();
+    currentMode = &driving_modes::tempomatMode;
+
+    const auto &frontLeft = controllers.unswapped_front.command.left;
+
+    // engages at the current speed
+    tick(2, 0, 0);
+    HOST_CHECK(frontLeft.cruiseCtrlEna);
+    HOST_CHECK(frontLeft.nCruiseMotTgt == 2);
+
+    // a light brake press lowers the setpoint, it stops at standstill
+    for (int i = 0; i < 30; ++i)
+    {
+        tick(2, 0, 400);
+        HOST_CHECK(frontLeft.cruiseCtrlEna);
+        HOST_CHECK(frontLeft.nCruiseMotTgt >= 0);
+    }
+    HOST_CHECK(frontLeft.nCruiseMotTgt == 0);
+
+    // a hard brake press disengages and brakes with pwm instead
+    tick(2, 0, 1000);
+    HOST_CHECK(!frontLeft.cruiseCtrlEna);
+    HOST_CHECK(frontLeft.nCruiseMotTgt == 0);
+    HOST_CHECK(frontLeft.pwm < 0);
+
+    // easing off stays on the brake path until the pedal is let go
+    tick(2, 0, 300);
+    HOST_CHECK(!frontLeft.cruiseCtrlEna);
+    HOST_CHECK(frontLeft.pwm < 0);
+
+    // and engages again at the speed that is left
+    tick(2, 0, 0);
+    HOST_CHECK(frontLeft.cruiseCtrlEna);
+    HOST_CHECK(frontLeft.nCruiseMotTgt == 2);
+    HOST_CHECK(frontLeft.pwm == 0);
+
+    return 0;
+}
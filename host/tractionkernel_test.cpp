@@ -0,0 +1,142 @@
+// system includes
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// local includes
+#include "driving_modes/tractionkernel.h"
+#include "hostcheck.h"
+
+using namespace driving_modes::traction;
+
+namespace {
+constexpr size_t WHEELS = 4;
+
+using Speeds = std::array<int16_t, WHEELS>;
+using Pwm = std::array<float, WHEELS>;
+
+constexpr std::array<uint8_t, WHEELS> allValid{1, 1, 1, 1};
+
+// 10% slip plus 20rpm allowed, fully cut 100rpm above that, 500ms to recover
+const Params params = makeParams(10.f, 20.f, 100.f, 500.f);
+
+State<WHEELS> freshState()
+{
+    State<WHEELS> state;
+    reset(state);
+    return state;
+}
+
+// A launch at full pwm, 10ms per tick, the car gaining 5rpm per tick. The back right wheel breaks loose at ONSET and
+// spins well past the allowed slip until HOOK_UP, where it runs with the others again.
+constexpr int TICKS = 150;
+constexpr int ONSET = 20;
+constexpr int HOOK_UP = 40;
+constexpr float REQUESTED = 500.f;
+
+std::array<Pwm, TICKS> launchTrace()
+{
+    auto state = freshState();
+    std::array<Pwm, TICKS> trace;
+
+    for (int tick = 0; tick < TICKS; ++tick)
+    {
+        const auto car = int16_t(5 * tick);
+        const bool spinning = tick >= ONSET && tick < HOOK_UP;
+        const auto backRight = spinning ? int16_t(car + car / 10 + 170) : car;
+
+        trace[tick] = {REQUESTED, REQUESTED, REQUESTED, REQUESTED};
+        step(params, state, Speeds{car, car, car, backRight}, allValid, trace[tick], 10.f);
+    }
+    return trace;
+}
+} // namespace
+
+int main()
+{
+    // a wheel spinning up while driving forward gets its pwm cut, the others keep theirs
+    {
+        auto state = freshState();
+        Pwm pwm{500.f, 500.f, 500.f, 500.f};
+        step(params, state, Speeds{100, 100, 100, 300}, allValid, pwm, 10.f);
+        HOST_CHECK_NEAR(pwm[0], 500.f, 1e-3);
+        HOST_CHECK_NEAR(pwm[2], 500.f, 1e-3);
+        HOST_CHECK_NEAR(pwm[3], 0.f, 1e-3);
+
+        // partially over the limit: 130rpm allowed, 50rpm above it is half the cut range
+        pwm = {500.f, 500.f, 500.f, 500.f};
+        state = freshState();
+        step(params, state, Speeds{100, 100, 100, 180}, allValid, pwm, 10.f);
+        HOST_CHECK_NEAR(pwm[3], 250.f, 1e-2);
+    }
+
+    // the same in reverse, and for a wheel mounted the other way round
+    {
+        auto state = freshState();
+        Pwm pwm{-500.f, -500.f, -500.f, -500.f};
+        step(params, state, Speeds{-100, -100, -100, -300}, allValid, pwm, 10.f);
+        HOST_CHECK_NEAR(pwm[0], -500.f, 1e-3);
+        HOST_CHECK_NEAR(pwm[3], 0.f, 1e-3);
+    }
+
+    // braking with a locked wheel: the locked wheel becomes the reference, but brake pwm must never be cut
+    {
+        auto state = freshState();
+        Pwm pwm{-500.f, -500.f, -500.f, -500.f};
+        step(params, state, Speeds{0, 300, 300, 300}, allValid, pwm, 10.f);
+        for (const auto value: pwm) HOST_CHECK_NEAR(value, -500.f, 1e-3);
+
+        // braking while rolling backwards
+        pwm = {500.f, 500.f, 500.f, 500.f};
+        step(params, state, Speeds{0, -300, -300, -300}, allValid, pwm, 10.f);
+        for (const auto value: pwm) HOST_CHECK_NEAR(value, 500.f, 1e-3);
+    }
+
+    // grip comes back rate limited once the wheel hooks up again, 2% per 10ms
+    {
+        auto state = freshState();
+        Pwm pwm{500.f, 500.f, 500.f, 500.f};
+        step(params, state, Speeds{100, 100, 100, 300}, allValid, pwm, 10.f);
+        HOST_CHECK_NEAR(state.grip[3], 0.f, 1e-3);
+
+        pwm = {500.f, 500.f, 500.f, 500.f};
+        step(params, state, Speeds{100, 100, 100, 100}, allValid, pwm, 10.f);
+        HOST_CHECK_NEAR(pwm[3], 10.f, 1e-2);
+
+        // a braking tick in between still lets the grip recover, and the brake pwm is untouched
+        pwm = {-500.f, -500.f, -500.f, -500.f};
+        step(params, state, Speeds{100, 100, 100, 100}, allValid, pwm, 10.f);
+        HOST_CHECK_NEAR(pwm[3], -500.f, 1e-3);
+        HOST_CHECK_NEAR(state.grip[3], 0.04f, 1e-4);
+    }
+
+    // launch with wheelspin: torque over time of the wheel that breaks loose, the others are never touched
+    {
+        const auto trace = launchTrace();
+
+        for (const auto &pwm: trace)
+            for (size_t i = 0; i < WHEELS - 1; ++i) HOST_CHECK_NEAR(pwm[i], REQUESTED, 1e-3);
+
+        // full torque until the onset, cut in the very tick the wheel spins and for as long as it does
+        for (int tick = 0; tick < ONSET; ++tick) HOST_CHECK_NEAR(trace[tick][3], REQUESTED, 1e-3);
+        for (int tick = ONSET; tick < HOOK_UP; ++tick) HOST_CHECK_NEAR(trace[tick][3], 0.f, 1e-3);
+
+        // once it hooks up, torque ramps back at 2% per tick, reaching full torque after the 500ms recovery time
+        for (int tick = HOOK_UP; tick < TICKS; ++tick)
+        {
+            const auto expected = REQUESTED * std::min(0.02f * (tick - HOOK_UP + 1), 1.f);
+            HOST_CHECK_NEAR(trace[tick][3], expected, 1e-2);
+            HOST_CHECK(trace[tick][3] >= trace[tick - 1][3]);
+        }
+        HOST_CHECK_NEAR(trace[HOOK_UP + 49][3], REQUESTED, 1e-2);
+        HOST_CHECK(trace[HOOK_UP + 48][3] < REQUESTED);
+    }
+
+    // without two valid wheels there is no reference
+    {
+        auto state = freshState();
+        Pwm pwm{500.f, 500.f, 500.f, 500.f};
+        step(params, state, Speeds{100, 100, 100, 300}, std::array<uint8_t, WHEELS>{0, 0, 0, 1}, pwm, 10.f);
+        HOST_CHECK_NEAR(pwm[3], 500.f, 1e-3);
+    }
+}
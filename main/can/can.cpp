@@ -2,20 +2,48 @@
 
 constexpr auto TAG = "BOBBYCAN";
 
+// system includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <tuple>
+
 // sdkconfig includes
 #include "sdkconfig.h"
 
 // esp-idf includes
 #include <driver/twai.h>
 #include <esp_log.h>
+#include <esp_timer.h>
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
 
 // 3rdparty lib includes
 #include <bobbycar-can.h>
 #include <tickchrono.h>
 
 // local includes
+#include "candispatch.h"
+#include "canfilter.h"
+#include "canoutputs.h"
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+#include "canrecorder.h"
+#endif
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+#include "canpacked.h"
+#endif
+#include "cantxschedule.h"
 #include "config/config.h"
+#include "config/configsnapshot.h"
 #include "driving_modes/controllers.h"
+#include "driving_modes/motorlanes.h"
+#include "utils/boottimeline.h"
+#include "utils/latencytrace.h"
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+#include "utils/spscring.h"
+#endif
 
 namespace can {
 
@@ -29,271 +57,673 @@ namespace inputs {
     std::atomic<std::optional<float>> brems;
 } // namespace inputs
 
-namespace outputs {
-    // value from motor controller in RPM
-    std::atomic<float> _averageSpeed;
-    const std::atomic<float> &averageSpeed{_averageSpeed};
-
-    // converted value from average_speed in km/h
-    std::atomic<float> _averageSpeedKmh;
-    const std::atomic<float> &averageSpeedKmh{_averageSpeedKmh};
+namespace stats {
+    std::atomic<uint32_t> _rxDrained;
+    const std::atomic<uint32_t> &rxDrained{_rxDrained};
 
-    // average acceleration in m/s^2
-    std::atomic<float> _averageAcceleration;
-    const std::atomic<float> &averageAcceleration{_averageAcceleration};
+    std::atomic<uint32_t> _rxLeftBehind;
+    const std::atomic<uint32_t> &rxLeftBehind{_rxLeftBehind};
 
-    // total current in A
-    std::atomic<float> _totalCurrent;
-    const std::atomic<float> &totalCurrent{_totalCurrent};
-} // namespace outputs
+    std::atomic<uint32_t> _rxRingDropped;
+    const std::atomic<uint32_t> &rxRingDropped{_rxRingDropped};
 
-namespace can_external {
-    // variables that can be read in from other modules via CAN
-    std::atomic<std::optional<int16_t>> _canGas;
-    const std::atomic<std::optional<int16_t>> &canGas{_canGas};
+    std::atomic<int64_t> _rxRingMaxLatencyUs;
+    const std::atomic<int64_t> &rxRingMaxLatencyUs{_rxRingMaxLatencyUs};
 
-    std::atomic<std::optional<int16_t>> _canBrems;
-    const std::atomic<std::optional<int16_t>> &canBrems{_canBrems};
+    std::atomic<uint32_t> _busRecoveries;
+    const std::atomic<uint32_t> &busRecoveries{_busRecoveries};
 
-    std::atomic<espchrono::millis_clock::time_point> _lastCanGas;
-    const std::atomic<espchrono::millis_clock::time_point> &lastCanGas{_lastCanGas};
+    std::atomic<uint32_t> _busRecoveryTimeMs;
+    const std::atomic<uint32_t> &busRecoveryTimeMs{_busRecoveryTimeMs};
 
-    std::atomic<espchrono::millis_clock::time_point> _lastCanBrems;
-    const std::atomic<espchrono::millis_clock::time_point> &lastCanBrems{_lastCanBrems};
-} // namespace can_external
+    std::atomic<uint32_t> _lastBusRecoveryMs;
+    const std::atomic<uint32_t> &lastBusRecoveryMs{_lastBusRecoveryMs};
+} // namespace stats
 
 bool can_initialized{false};
 
 namespace {
 
-    uint32_t can_sequential_error_cnt{0};
-    uint32_t can_sequential_bus_errors{0};
     uint32_t can_total_error_cnt{0};
 
     constexpr auto CAN_TIMEOUT = CONFIG_BOBBYCAR_CAN_CONTROLLER_VALID_TIMEOUT_MS * 1ms;
 
-    enum class ControllerType
+    auto hardwareConfig()
+    {
+        return config::snapshot.read([](const config::Snapshot &s) { return s.controllerHardware; });
+    }
+
+    // worst case length of a standard frame including interframe space: 47 fixed bits plus the data, and one stuff bit
+    // per 4 bits of the 34 + 8 * dataBytes bits from SOF to the end of the CRC
+    constexpr size_t frameBits(const size_t dataBytes)
     {
-        Front,
-        Back
+        return 47 + 8 * dataBytes + (34 + 8 * dataBytes - 1) / 4;
+    }
+
+    static_assert(frameBits(2) == 75);
+    static_assert(frameBits(8) == 135);
+
+    // longest frame sendCanCommands() queues: parameter slots, a single InpTgt value or the packed InpTgt frame
+    constexpr size_t TX_MAX_DATA_BYTES = [] {
+        size_t bytes = sizeof(int16_t);
+        for (const auto &slot: txschedule::slots) bytes = std::max<size_t>(bytes, slot.size);
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+        bytes = std::max(bytes, packed::inpTgtLayout.size() * sizeof(int16_t));
+#endif
+        return bytes;
+    }();
+
+    constexpr size_t CAN_FRAME_BITS = frameBits(TX_MAX_DATA_BYTES);
+    constexpr size_t CAN_BITRATE = 250000;
+
+    // frames sendCanCommands() may queue per drive tick, at least the InpTgt frames of every board plus one parameter
+    constexpr size_t TX_FRAMES_PER_TICK =
+            std::max<size_t>(CAN_BITRATE / 1000 * CONFIG_BOBBYCAR_DRIVE_UPDATE_INTERVAL_MS *
+                                     CONFIG_BOBBYCAR_CAN_TX_BUS_SHARE_PERCENT / 100 / CAN_FRAME_BITS,
+                             boards::COUNT * 2 + 1);
+
+    struct TxSlotState
+    {
+        uint32_t lastValue{};
+        espchrono::millis_clock::time_point lastSent{};
+        bool sent{false};
     };
 
-} // namespace
+    std::array<TxSlotState, txschedule::slots.size()> txSlotStates{};
 
-template<ControllerType Type>
-bool parseMotorControllerCanMessage(const twai_message_t &message, Controller &controller)
-{
-    constexpr auto isBack = Type == ControllerType::Back;
+    constexpr auto INPTGT_KEEPALIVE = CONFIG_BOBBYCAR_CAN_INPTGT_KEEPALIVE_MS * 1ms;
 
-    switch (message.identifier)
+    struct InpTgtState
     {
-        using namespace bobbycar::protocol::can;
-        case MotorController<isBack, false>::Feedback::DcLink:
-            controller.feedback.left.dcLink = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::DcLink:
-            controller.feedback.right.dcLink = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Speed:
-            controller.feedback.left.speed = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::Speed:
-            controller.feedback.right.speed = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Error:
-            controller.feedback.left.error = *((int8_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::Error:
-            controller.feedback.right.error = *((int8_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Angle:
-            controller.feedback.left.angle = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::Angle:
-            controller.feedback.right.angle = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::DcPhaA:
-            controller.feedback.left.dcPhaA = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::DcPhaA:
-            controller.feedback.right.dcPhaA = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::DcPhaB:
-            controller.feedback.left.dcPhaB = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::DcPhaB:
-            controller.feedback.right.dcPhaB = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::DcPhaC:
-            controller.feedback.left.dcPhaC = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::DcPhaC:
-            controller.feedback.right.dcPhaC = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Chops:
-            controller.feedback.left.chops = *((uint16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::Chops:
-            controller.feedback.right.chops = *((uint16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Hall:
-            controller.feedback.left.hallA = *((uint8_t *) message.data) & 1;
-            controller.feedback.left.hallB = *((uint8_t *) message.data) & 2;
-            controller.feedback.left.hallC = *((uint8_t *) message.data) & 4;
-            return true;
-        case MotorController<isBack, true>::Feedback::Hall:
-            controller.feedback.right.hallA = *((uint8_t *) message.data) & 1;
-            controller.feedback.right.hallB = *((uint8_t *) message.data) & 2;
-            controller.feedback.right.hallC = *((uint8_t *) message.data) & 4;
-            return true;
-        case MotorController<isBack, false>::Feedback::Voltage:
-        case MotorController<isBack, true>::Feedback::Voltage:
-            controller.feedback.batVoltage = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Temp:
-        case MotorController<isBack, true>::Feedback::Temp:
-            controller.feedback.boardTemp = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Id:
-            controller.feedback.left.id = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::Id:
-            controller.feedback.right.id = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, false>::Feedback::Iq:
-            controller.feedback.left.iq = *((int16_t *) message.data);
-            return true;
-        case MotorController<isBack, true>::Feedback::Iq:
-            controller.feedback.right.iq = *((int16_t *) message.data);
-            return true;
-        default:
-            return false;
+        int16_t left{};
+        int16_t right{};
+        espchrono::millis_clock::time_point lastSent{};
+    };
+
+    std::array<InpTgtState, boards::COUNT> inpTgtStates{};
+
+    // InpTgt is streamed every drive tick, except while both motors of a board regulate the cruise speed on their own,
+    // then it is only sent when it changed or as keepalive
+    bool inpTgtDue(const size_t board, const Controller &controller, const espchrono::millis_clock::time_point now)
+    {
+        const auto &command = controller.command;
+        const auto &state = inpTgtStates[board];
+
+        const bool cruising = command.left.cruiseCtrlEna && command.right.cruiseCtrlEna;
+        return !cruising || command.left.pwm != state.left || command.right.pwm != state.right ||
+               now - state.lastSent >= INPTGT_KEEPALIVE;
     }
-}
 
-bool parseBoardcomputerCanMessage(const twai_message_t &message)
-{
-    switch (message.identifier)
+    void inpTgtSent(const size_t board, const Controller &controller, const espchrono::millis_clock::time_point now)
     {
-        using namespace bobbycar::protocol::can;
-        case Boardcomputer::Command::RawButtonPressed:
-            // if (espgui::currentDisplay) espgui::currentDisplay->rawButtonPressed(*((const uint8_t *) message.data));
-            return true;
-        case Boardcomputer::Command::RawButtonReleased:
-            // if (espgui::currentDisplay) espgui::currentDisplay->rawButtonReleased(*((const uint8_t *) message.data));
-            return true;
-        case Boardcomputer::Command::ButtonPressed:
-            // if (espgui::currentDisplay)
-            //     espgui::currentDisplay->buttonPressed(espgui::Button(*((const uint8_t *) message.data)));
-            return true;
-        case Boardcomputer::Command::ButtonReleased:
-            // if (espgui::currentDisplay)
-            //     espgui::currentDisplay->buttonReleased(espgui::Button(*((const uint8_t *) message.data)));
-            return true;
-        case Boardcomputer::Command::RawGas:
-            // can_gas = *((int16_t *) message.data);
-            // last_can_gas = espchrono::millis_clock::now();
-            return true;
-        case Boardcomputer::Command::RawBrems:
-            // can_brems = *((int16_t *) message.data);
-            // last_can_brems = espchrono::millis_clock::now();
-            return true;
-        default:
-            return false;
+        inpTgtStates[board] = {controller.command.left.pwm, controller.command.right.pwm, now};
     }
-}
 
-bool tryParseCanInput()
-{
-    using namespace config;
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+    static_assert(std::ranges::none_of(txschedule::slots,
+                                       [](const txschedule::Slot &slot) {
+                                           return slot.identifier >= packed::InpTgt &&
+                                                  slot.identifier <= packed::BackIqId;
+                                       }),
+                  "packed identifiers collide with command identifiers");
+#endif
+
+    constexpr twai_general_config_t g_config = [] {
+        twai_general_config_t config = TWAI_GENERAL_CONFIG_DEFAULT(GPIO_NUM_21, GPIO_NUM_22, TWAI_MODE_NORMAL);
+        config.rx_queue_len = CONFIG_BOBBYCAR_CAN_RX_QUEUE_LEN;
+        // a whole tick worth of commands fits into the driver queue
+        config.tx_queue_len = TX_FRAMES_PER_TICK;
+        config.alerts_enabled = TWAI_ALERT_BUS_OFF | TWAI_ALERT_BUS_RECOVERED | TWAI_ALERT_ERR_PASS |
+                                TWAI_ALERT_ERR_ACTIVE | TWAI_ALERT_TX_FAILED | TWAI_ALERT_TX_SUCCESS;
+        return config;
+    }();
+    constexpr twai_timing_config_t t_config = TWAI_TIMING_CONFIG_250KBITS();
+#ifdef CONFIG_BOBBYCAR_CAN_HARDWARE_FILTER
+    constexpr twai_filter_config_t f_config = filter::filterConfig;
+#else
+    constexpr twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+#endif
 
-    twai_message_t message;
+    // how long a bus off recovery may take before the driver gets restarted
+    constexpr auto RECOVERY_TIMEOUT = 500ms;
+    constexpr auto RESTART_BACKOFF_MIN = 100ms;
+    constexpr auto RESTART_BACKOFF_MAX = 5s;
 
-    const auto timeout = configs.controllerHardware.canReceiveTimeout.value();
+    enum class BusState : uint8_t
+    {
+        Running,
+        Recovering, // bus off, hardware recovery initiated
+        Restarting  // waiting for the next driver restart attempt
+    };
 
-    if (const auto receiveResult = twai_receive(&message, timeout); receiveResult != ESP_OK)
+    struct
     {
-        if (receiveResult != ESP_ERR_TIMEOUT)
+        BusState state{BusState::Running};
+        uint32_t sequentialTxFailures{0};
+        espchrono::millis_clock::time_point recoveryStarted{};
+        // start of the current wait for TWAI_ALERT_BUS_RECOVERED, one recovery can take several of them
+        espchrono::millis_clock::time_point recoveryAttemptStarted{};
+        espchrono::millis_clock::time_point nextRestart{};
+        espchrono::millis_clock::duration restartBackoff{RESTART_BACKOFF_MIN};
+    } bus;
+
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+    struct RxFrame
+    {
+        int64_t timestamp; // esp_timer_get_time() when twai_receive() returned
+        twai_message_t message;
+    };
+
+    SpscRing<RxFrame, CONFIG_BOBBYCAR_CAN_RX_RING_SIZE> rxRing;
+
+    TaskHandle_t rxTaskHandle{};
+
+    // twai_receive() keeps waiting on the driver queue when the driver gets stopped, so the RX task wakes up this
+    // often to see whether it has to get out of the way of a driver reinstall
+    constexpr TickType_t RX_PARK_POLL = pdMS_TO_TICKS(10);
+    constexpr TickType_t RX_PARK_TIMEOUT = RX_PARK_POLL * 5;
+
+    std::atomic<bool> rxParkRequested{false};
+    std::atomic<bool> rxParked{false};
+
+    [[noreturn]] void rxTask(void *)
+    {
+        while (true)
         {
-            ESP_LOGE(TAG, "twai_receive() failed with %s", esp_err_to_name(receiveResult));
+            if (rxParkRequested.load(std::memory_order_acquire))
+            {
+                rxParked.store(true, std::memory_order_release);
+                while (rxParkRequested.load(std::memory_order_acquire)) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+                rxParked.store(false, std::memory_order_release);
+                continue;
+            }
+
+            RxFrame frame;
+
+            if (const auto receiveResult = twai_receive(&frame.message, RX_PARK_POLL); receiveResult != ESP_OK)
+            {
+                if (receiveResult != ESP_ERR_TIMEOUT)
+                {
+                    // driver is stopped, do not spin
+                    ESP_LOGE(TAG, "twai_receive() failed with %s", esp_err_to_name(receiveResult));
+                    vTaskDelay(pdMS_TO_TICKS(10));
+                }
+                continue;
+            }
+
+            frame.timestamp = esp_timer_get_time();
+
+            if (!rxRing.push(frame)) ++stats::_rxRingDropped;
         }
+    }
 
-        if (espchrono::millis_clock::now() - controllers.unswapped_front.lastCanFeedback > CAN_TIMEOUT)
+    // twai_driver_uninstall() frees the queue twai_receive() waits on, the RX task has to be parked outside of it
+    // first. Returns false if it did not get there in time.
+    bool parkRxTask()
+    {
+        if (!rxTaskHandle) return true;
+
+        rxParkRequested.store(true, std::memory_order_release);
+
+        for (TickType_t waited = 0; !rxParked.load(std::memory_order_acquire); ++waited)
         {
-            controllers.unswapped_front.feedbackValid = false;
+            if (waited >= RX_PARK_TIMEOUT) return false;
+            vTaskDelay(1);
         }
-        else
+        return true;
+    }
+
+    void unparkRxTask()
+    {
+        if (!rxTaskHandle) return;
+
+        rxParkRequested.store(false, std::memory_order_release);
+        xTaskNotifyGive(rxTaskHandle);
+    }
+#endif
+
+    bool reinstallDriver()
+    {
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+        if (!parkRxTask())
         {
-            ESP_LOGD(TAG, "frontTimeout: %lldms, %s", espchrono::ago(controllers.unswapped_front.lastCanFeedback) / 1ms,
-                     esp_err_to_name(receiveResult));
+            ESP_LOGE(TAG, "can_rx did not leave twai_receive(), restarting without reinstall");
+            unparkRxTask();
+            return true;
         }
+#endif
 
-        if (espchrono::millis_clock::now() - controllers.unswapped_back.lastCanFeedback > CAN_TIMEOUT)
+        if (const auto err = twai_driver_uninstall(); err != ESP_OK)
         {
-            controllers.unswapped_back.feedbackValid = false;
+            ESP_LOGE(TAG, "twai_driver_uninstall() failed with %s", esp_err_to_name(err));
         }
-        else
+
+        if (const auto err = twai_driver_install(&g_config, &t_config, &f_config); err != ESP_OK)
+        {
+            // can_rx stays parked until a later restart installed the driver again
+            ESP_LOGE(TAG, "twai_driver_install() failed with %s", esp_err_to_name(err));
+            return false;
+        }
+
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+        unparkRxTask();
+#endif
+        return true;
+    }
+
+    enum class RestartResult : uint8_t
+    {
+        Running,
+        Recovering, // the controller has to finish a bus off recovery first
+        Failed
+    };
+
+    // twai_stop() and twai_start() only work on a controller that is not bus off, so a restart that catches it bus
+    // off or recovering has to go through the recovery. Uninstalling is allowed while bus off, but not while
+    // recovering.
+    RestartResult restartDriver()
+    {
+        using namespace config;
+
+        ESP_LOGW(TAG, "Something isn't right, trying to restart can ic...");
+
+        twai_status_info_t status;
+        const bool installed = twai_get_status_info(&status) == ESP_OK;
+        const bool reinstall = hardwareConfig().canUninstallOnReset || !installed;
+
+        if (installed)
         {
-            ESP_LOGD(TAG, "backTimeout: %lldms, %s", espchrono::ago(controllers.unswapped_back.lastCanFeedback) / 1ms,
-                     esp_err_to_name(receiveResult));
+            switch (status.state)
+            {
+                case TWAI_STATE_RECOVERING:
+                    ESP_LOGW(TAG, "CAN controller still recovering from bus off");
+                    return RestartResult::Recovering;
+                case TWAI_STATE_BUS_OFF:
+                    if (reinstall) break;
+                    if (const auto err = twai_initiate_recovery(); err != ESP_OK)
+                    {
+                        ESP_LOGE(TAG, "twai_initiate_recovery() failed with %s", esp_err_to_name(err));
+                        return RestartResult::Failed;
+                    }
+                    return RestartResult::Recovering;
+                case TWAI_STATE_RUNNING:
+                    if (const auto err = twai_stop(); err != ESP_OK)
+                    {
+                        ESP_LOGE(TAG, "twai_stop() failed with %s", esp_err_to_name(err));
+                    }
+                    break;
+                case TWAI_STATE_STOPPED:
+                    break;
+            }
         }
 
-        if (!controllers.unswapped_front.feedbackValid || !controllers.unswapped_back.feedbackValid)
+        if (reinstall && !reinstallDriver()) return RestartResult::Failed;
+
+        if (const auto err = twai_start(); err != ESP_OK)
         {
-            return false;
+            ESP_LOGE(TAG, "twai_start() failed with %s", esp_err_to_name(err));
+            return RestartResult::Failed;
         }
+        return RestartResult::Running;
     }
 
-    if (!configs.controllerHardware.recvCanCmd.value())
+    void beginRecovery(const espchrono::millis_clock::time_point now)
     {
-        if (espchrono::millis_clock::now() - controllers.unswapped_front.lastCanFeedback > CAN_TIMEOUT)
-            controllers.unswapped_front.feedbackValid = false;
+        bus.recoveryStarted = now;
+        ++stats::_busRecoveries;
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+        // keep the traffic that led up to the bus error
+        recorder::requestFlush();
+#endif
+    }
 
-        if (espchrono::millis_clock::now() - controllers.unswapped_back.lastCanFeedback > CAN_TIMEOUT)
-            controllers.unswapped_back.feedbackValid = false;
+    void finishRecovery(const espchrono::millis_clock::time_point now)
+    {
+        const auto duration = std::chrono::floor<std::chrono::milliseconds>(now - bus.recoveryStarted).count();
 
-        return false;
+        ESP_LOGI(TAG, "CAN bus recovered after %lldms", duration);
+
+        stats::_lastBusRecoveryMs = duration;
+        stats::_busRecoveryTimeMs += duration;
+
+        bus.state = BusState::Running;
+        bus.sequentialTxFailures = 0;
+        bus.restartBackoff = RESTART_BACKOFF_MIN;
     }
 
-    auto &front = controllers.correctedFront();
-    auto &back = controllers.correctedBack();
+    void scheduleRestart(const espchrono::millis_clock::time_point now)
+    {
+        bus.state = BusState::Restarting;
+        bus.nextRestart = now;
+    }
 
-    if (parseMotorControllerCanMessage<ControllerType::Front>(message, front))
+    // bus error and bus off state machine, runs once per CAN task run instead of after every transmit
+    void handleBusAlerts()
     {
-        if (espchrono::millis_clock::now() - back.lastCanFeedback > CAN_TIMEOUT) back.feedbackValid = false;
+        using namespace config;
 
-        front.lastCanFeedback = espchrono::millis_clock::now();
-        front.feedbackValid = true;
-        return true;
+        uint32_t alerts{};
+        if (twai_read_alerts(&alerts, 0) != ESP_OK) alerts = 0;
+
+        const auto now = espchrono::millis_clock::now();
+
+        if (alerts & TWAI_ALERT_ERR_PASS) ESP_LOGW(TAG, "CAN controller is error passive");
+        if (alerts & TWAI_ALERT_ERR_ACTIVE) ESP_LOGI(TAG, "CAN controller is error active again");
+
+        if (alerts & TWAI_ALERT_TX_FAILED)
+            ++bus.sequentialTxFailures;
+        else if (alerts & TWAI_ALERT_TX_SUCCESS)
+            bus.sequentialTxFailures = 0;
+
+        switch (bus.state)
+        {
+            case BusState::Running:
+                if (alerts & TWAI_ALERT_BUS_OFF)
+                {
+                    ESP_LOGW(TAG, "CAN bus off, initiating recovery");
+                    beginRecovery(now);
+                    if (twai_initiate_recovery() == ESP_OK)
+                    {
+                        bus.state = BusState::Recovering;
+                        bus.recoveryAttemptStarted = now;
+                    }
+                    else
+                        scheduleRestart(now);
+                }
+                else if (bus.sequentialTxFailures > CONFIG_BOBBYCAR_CAN_CONTROLLER_MAX_ERROR_COUNT &&
+                         hardwareConfig().canBusResetOnError)
+                {
+                    beginRecovery(now);
+                    scheduleRestart(now);
+                }
+                break;
+            case BusState::Recovering:
+                if (alerts & TWAI_ALERT_BUS_RECOVERED)
+                {
+                    if (const auto err = twai_start(); err == ESP_OK)
+                    {
+                        finishRecovery(now);
+                    }
+                    else
+                    {
+                        ESP_LOGE(TAG, "twai_start() failed with %s", esp_err_to_name(err));
+                        scheduleRestart(now);
+                    }
+                }
+                else if (now - bus.recoveryAttemptStarted > RECOVERY_TIMEOUT &&
+                         hardwareConfig().canBusResetOnError)
+                {
+                    scheduleRestart(now);
+                }
+                break;
+            case BusState::Restarting:
+                if (now < bus.nextRestart) break;
+
+                switch (restartDriver())
+                {
+                    case RestartResult::Running:
+                        finishRecovery(espchrono::millis_clock::now());
+                        break;
+                    case RestartResult::Recovering:
+                        bus.state = BusState::Recovering;
+                        bus.recoveryAttemptStarted = now;
+                        break;
+                    case RestartResult::Failed:
+                        bus.nextRestart = now + bus.restartBackoff;
+                        bus.restartBackoff = std::min<espchrono::millis_clock::duration>(bus.restartBackoff * 2,
+                                                                                         RESTART_BACKOFF_MAX);
+                        break;
+                }
+                break;
+        }
+    }
+
+    constexpr uint8_t NO_BOARD = 0xFF;
+
+    // resolved once per CAN task run, so a frame batch never sees swapFrontBack change halfway through
+    boards::Resolved resolveBoards()
+    {
+        const bool swap = hardwareConfig().swapFrontBack;
+
+        boards::Resolved result;
+        for (size_t i = 0; i < result.size(); ++i) result[i] = &controllers.unswapped(i < 2 && swap ? i ^ 1 : i);
+        return result;
+    }
+
+    // esp_timer_get_time() of the newest frame that carried a speed lane
+    int64_t speedFrameTimestamp{};
+
+    // decodes a single frame received at timestamp, returns the index of the board that received new feedback or
+    // NO_BOARD
+    uint8_t parseCanMessage(const twai_message_t &message, const int64_t timestamp, const boards::Resolved &boards)
+    {
+        const auto &route = dispatch::lookup(message.identifier);
+
+        Controller *controller{};
+        switch (route.target)
+        {
+            case dispatch::Target::Board:
+                controller = boards[route.board];
+                break;
+            case dispatch::Target::Boardcomputer:
+                break;
+            case dispatch::Target::None:
+                ESP_LOGW(TAG, "Unknown CAN info received .identifier = %lu", message.identifier);
+                break;
+        }
+
+        if (route.decode) route.decode(message, controller);
+
+        if (controller && route.speed) speedFrameTimestamp = timestamp;
+
+        return controller ? route.board : NO_BOARD;
     }
 
-    if (espchrono::millis_clock::now() - front.lastCanFeedback > CAN_TIMEOUT) front.feedbackValid = false;
+    // publishes the lanes along with the validity of their boards and refreshes can::outputs from them
+    void publishLanes(const boards::Resolved &boards)
+    {
+        for (size_t i = 0; i < boards.size(); ++i)
+        {
+            const bool valid = boards[i]->feedbackValid;
+            motorlanes::feedback.valid[motorlanes::index(i, false)] = valid;
+            motorlanes::feedback.valid[motorlanes::index(i, true)] = valid;
+        }
+
+        motorlanes::feedbackSnapshot.publish(motorlanes::feedback);
+        outputs::update(motorlanes::feedback, speedFrameTimestamp);
+    }
 
-    if (parseMotorControllerCanMessage<ControllerType::Back>(message, back))
+    void feedbackLost(Controller &controller)
     {
-        back.lastCanFeedback = espchrono::millis_clock::now();
-        back.feedbackValid = true;
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+        // keep the traffic that led up to the board going silent
+        if (controller.feedbackValid) recorder::requestFlush();
+#endif
+        controller.feedbackValid = false;
+    }
+
+    void checkFeedbackTimeout(Controller &controller, const espchrono::millis_clock::time_point now)
+    {
+        if (now - controller.lastCanFeedback > CAN_TIMEOUT) feedbackLost(controller);
+    }
+
+    // non-blocking fetch of the next frame for drainCanInput(), timestamp is esp_timer_get_time() of its reception
+    bool receiveCanMessage(twai_message_t &message, int64_t &timestamp)
+    {
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+        RxFrame frame;
+        if (!rxRing.pop(frame)) return false;
+
+        if (const auto latency = esp_timer_get_time() - frame.timestamp; latency > stats::_rxRingMaxLatencyUs)
+            stats::_rxRingMaxLatencyUs = latency;
+
+        message = frame.message;
+        timestamp = frame.timestamp;
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+        recorder::record(recorder::Direction::Rx, message, timestamp);
+#endif
         return true;
+#else
+        if (const auto receiveResult = twai_receive(&message, 0); receiveResult != ESP_OK)
+        {
+            if (receiveResult != ESP_ERR_TIMEOUT)
+            {
+                ESP_LOGE(TAG, "twai_receive() failed with %s", esp_err_to_name(receiveResult));
+            }
+            return false;
+        }
+        timestamp = esp_timer_get_time();
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+        recorder::record(recorder::Direction::Rx, message, timestamp);
+#endif
+        return true;
+#endif
+    }
+
+} // namespace
+
+bool tryParseCanInput()
+{
+    twai_message_t message;
+
+    const auto hardware = hardwareConfig();
+
+    if (const auto receiveResult = twai_receive(&message, hardware.canReceiveTimeout); receiveResult != ESP_OK)
+    {
+        if (receiveResult != ESP_ERR_TIMEOUT)
+        {
+            ESP_LOGE(TAG, "twai_receive() failed with %s", esp_err_to_name(receiveResult));
+        }
+
+        bool allValid{true};
+        for (size_t i = 0; i < controllers.size(); ++i)
+        {
+            auto &controller = controllers.unswapped(i);
+
+            if (espchrono::millis_clock::now() - controller.lastCanFeedback > CAN_TIMEOUT)
+            {
+                feedbackLost(controller);
+            }
+            else
+            {
+                ESP_LOGD(TAG, "board %zu timeout: %lldms, %s", i, espchrono::ago(controller.lastCanFeedback) / 1ms,
+                         esp_err_to_name(receiveResult));
+            }
+
+            allValid &= controller.feedbackValid;
+        }
+
+        if (!allValid)
+        {
+            return false;
+        }
+    }
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+    else
+    {
+        recorder::record(recorder::Direction::Rx, message, esp_timer_get_time());
+    }
+#endif
+
+    if (!hardware.recvCanCmd)
+    {
+        const auto now = espchrono::millis_clock::now();
+        for (size_t i = 0; i < controllers.size(); ++i) checkFeedbackTimeout(controllers.unswapped(i), now);
+
+        return false;
     }
 
-    if (espchrono::millis_clock::now() - back.lastCanFeedback > CAN_TIMEOUT) back.feedbackValid = false;
+    const auto boards = resolveBoards();
 
-    if (parseBoardcomputerCanMessage(message)) return true;
+    const auto board = parseCanMessage(message, esp_timer_get_time(), boards);
 
-    ESP_LOGW(TAG, "Unknown CAN info received .identifier = %lu", message.identifier);
+    const auto now = espchrono::millis_clock::now();
+
+    if (board != NO_BOARD)
+    {
+        auto &controller = *boards[board];
+        controller.lastCanFeedback = now;
+        controller.feedbackValid = true;
+        controller.feedbackSnapshot.publish(controller.feedback);
+    }
+
+    for (size_t i = 0; i < boards.size(); ++i)
+        if (i != board) checkFeedbackTimeout(*boards[i], now);
+
+    if (board != NO_BOARD) publishLanes(boards);
 
     return true;
 }
 
+void drainCanInput()
+{
+    const auto boards = resolveBoards();
+
+    uint32_t drained{0};
+    std::array<bool, boards::COUNT> updated{};
+
+    if (hardwareConfig().recvCanCmd)
+    {
+        const auto start = esp_timer_get_time();
+        const auto receivedAt = espchrono::millis_clock::now();
+
+        twai_message_t message;
+        int64_t timestamp;
+        while (drained < CONFIG_BOBBYCAR_CAN_RX_DRAIN_MAX_FRAMES &&
+               esp_timer_get_time() - start < CONFIG_BOBBYCAR_CAN_RX_DRAIN_BUDGET_US &&
+               receiveCanMessage(message, timestamp))
+        {
+            ++drained;
+
+            if (const auto board = parseCanMessage(message, timestamp, boards); board != NO_BOARD)
+            {
+                boards[board]->lastCanFeedback = receivedAt;
+                boards[board]->feedbackValid = true;
+                updated[board] = true;
+            }
+        }
+    }
+
+    const auto now = espchrono::millis_clock::now();
+
+    // publish once per drain, readers never see a frame batch half applied
+    bool changed{false};
+    for (size_t i = 0; i < boards.size(); ++i)
+    {
+        auto &controller = *boards[i];
+
+        if (updated[i]) controller.feedbackSnapshot.publish(controller.feedback);
+
+        const bool wasValid = controller.feedbackValid;
+        checkFeedbackTimeout(controller, now);
+
+        changed |= updated[i] || controller.feedbackValid != wasValid;
+    }
+
+    if (changed) publishLanes(boards);
+
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+    const auto leftBehind = rxRing.size();
+#else
+    twai_status_info_t status_info;
+    const auto leftBehind = twai_get_status_info(&status_info) == ESP_OK ? status_info.msgs_to_rx : 0;
+#endif
+
+    stats::_rxDrained = drained;
+    stats::_rxLeftBehind = leftBehind;
+}
+
 void initCan()
 {
     can_initialized = true;
 
     ESP_LOGI(TAG, "Initializing CAN bus...");
 
-    constexpr twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(GPIO_NUM_21, GPIO_NUM_22, TWAI_MODE_NORMAL);
-    constexpr twai_timing_config_t t_config = TWAI_TIMING_CONFIG_250KBITS();
-    constexpr twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+#ifdef CONFIG_BOBBYCAR_CAN_HARDWARE_FILTER
+    ESP_LOGI(TAG, "%s acceptance filter code=0x%08lx mask=0x%08lx lets %lu foreign identifiers through",
+             filter::choice.dual ? "dual" : "single", f_config.acceptance_code, f_config.acceptance_mask,
+             filter::foreignIdentifiers);
+#endif
 
     if (const auto installResult = twai_driver_install(&g_config, &t_config, &f_config); installResult == ESP_OK)
     {
@@ -327,6 +757,17 @@ void initCan()
         return;
     }
 
+#ifdef CONFIG_BOBBYCAR_CAN_RX_TASK
+    if (!rxTaskHandle)
+    {
+        if (xTaskCreatePinnedToCore(rxTask, "can_rx", 3072, nullptr, CONFIG_BOBBYCAR_CAN_RX_TASK_PRIORITY,
+                                    &rxTaskHandle, CONFIG_BOBBYCAR_CAN_RX_TASK_CORE) != pdPASS)
+        {
+            ESP_LOGE(TAG, "xTaskCreatePinnedToCore() for can_rx failed");
+        }
+    }
+#endif
+
     ESP_LOGI(TAG, "CAN bus initialized");
 
     can_initialized = true;
@@ -334,6 +775,11 @@ void initCan()
 
 void updateCan()
 {
+    if (can_initialized) handleBusAlerts();
+
+#ifdef CONFIG_BOBBYCAR_CAN_RX_DRAIN
+    drainCanInput();
+#else
     for (int i = 0; i < 4; i++)
     {
         if (!tryParseCanInput())
@@ -341,285 +787,201 @@ void updateCan()
             break;
         }
     }
+#endif
 }
 
-esp_err_t sendCommand(const uint32_t addr, auto value)
+esp_err_t sendFrame(const uint32_t addr, const void *data, const uint8_t size)
 {
     using namespace config;
 
     twai_message_t message;
-    twai_status_info_t status_info;
 
     message.identifier = addr;
     message.flags = TWAI_MSG_FLAG_SS;
-    message.data_length_code = sizeof(value);
+    message.data_length_code = size;
 
     std::ranges::fill(message.data, 0);
-    std::memcpy(message.data, &value, sizeof(value));
-
-    const auto timeout = configs.controllerHardware.canTransmitTimeout.value();
+    std::memcpy(message.data, data, size);
 
-    const auto timestamp_before = espchrono::millis_clock::now();
-    const auto result = twai_transmit(&message, timeout);
-    const auto status = twai_get_status_info(&status_info);
-    const auto timestamp_after = espchrono::millis_clock::now();
+    const auto timeout = hardwareConfig().canTransmitTimeout;
 
-    if ((result == ESP_ERR_TIMEOUT || status_info.state == TWAI_STATE_BUS_OFF) ||
-        (status == ESP_OK && status_info.bus_error_count > can_sequential_bus_errors))
-    {
-        ++can_sequential_error_cnt;
-        ++can_total_error_cnt;
-        can_sequential_bus_errors = status_info.bus_error_count;
-
-        if (can_total_error_cnt < 500 &&
-            (configs.controllerHardware.canUninstallOnReset.value() && can_total_error_cnt < 100))
-            ESP_LOGW(TAG, "twai_transmit() failed after %lldms with %s, seq err: %lu, total err: %lu",
-                     std::chrono::floor<std::chrono::milliseconds>(timestamp_after - timestamp_before).count(),
-                     esp_err_to_name(result), can_sequential_error_cnt, can_total_error_cnt);
-    }
-    else if (result != ESP_OK)
+    // bus errors are reported through alerts and handled by handleBusAlerts(), nothing to query here
+    if (const auto result = twai_transmit(&message, timeout); result != ESP_OK)
     {
-        ESP_LOGE(TAG, "twai_transmit() failed after %lldms with %s",
-                 std::chrono::floor<std::chrono::milliseconds>(timestamp_after - timestamp_before).count(),
-                 esp_err_to_name(result));
+        if (++can_total_error_cnt < 100)
+            ESP_LOGW(TAG, "twai_transmit() failed with %s, total err: %lu", esp_err_to_name(result),
+                     can_total_error_cnt);
+        return result;
     }
-    else
+
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+    recorder::record(recorder::Direction::Tx, message, esp_timer_get_time());
+#endif
+
+    return ESP_OK;
+}
+
+esp_err_t sendCommand(const uint32_t addr, auto value)
+{
+    return sendFrame(addr, &value, sizeof(value));
+}
+
+void sendCanCommands()
+{
+    using namespace config;
+
+    const auto hardware = hardwareConfig();
+
+    const auto boards = resolveBoards();
+
+    // the send switches belong to the physical front and back board, boards past those two are always commanded
+    std::array<const Controller *, boards::COUNT> targets;
+    for (size_t i = 0; i < targets.size(); ++i)
     {
-        can_sequential_error_cnt = 0;
+        const auto physical = i < 2 && hardware.swapFrontBack ? i ^ 1 : i;
+        const bool send = physical == 0 ? hardware.sendFrontCanCmd
+                        : physical == 1 ? hardware.sendBackCanCmd
+                                        : true;
+        targets[i] = send ? boards[i] : nullptr;
     }
 
-    if (can_sequential_error_cnt > CONFIG_BOBBYCAR_CAN_CONTROLLER_MAX_ERROR_COUNT)
+    if (std::ranges::none_of(targets, [](const Controller *controller) { return controller; })) return;
+
+    // the driver rejects transmits until the recovery state machine brought it back up
+    if (bus.state != BusState::Running) return;
+
+    const auto now = espchrono::millis_clock::now();
+
+    size_t sent{0};
+
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+    // the clock starts at boot, a board that never sent packed feedback would look recent for the first CAN_TIMEOUT
+    const auto understandsPacked = [&now](const Controller &controller) {
+        return controller.lastPackedFeedback != espchrono::millis_clock::time_point{} &&
+               now - controller.lastPackedFeedback <= CAN_TIMEOUT;
+    };
+
+    // the packed frame only carries lanes for the front and back board
+    const Controller *front = targets[0];
+    const Controller *back = targets[1];
+
+    // every board that understands the packed frame reads its lanes from it, so it may only be used if none of them
+    // has commands disabled
+    const std::array<bool, 2> packedBoards{understandsPacked(*boards[0]), understandsPacked(*boards[1])};
+    const bool usePacked = (packedBoards[0] || packedBoards[1]) && (front || !packedBoards[0]) &&
+                           (back || !packedBoards[1]);
+
+    // the packed frame carries every lane, one board that needs it is enough to send it
+    const bool packedDue = (front && packedBoards[0] && inpTgtDue(0, *front, now)) ||
+                           (back && packedBoards[1] && inpTgtDue(1, *back, now));
+
+    if (usePacked && packedDue)
     {
-        can_sequential_error_cnt = 0;
-        if (configs.controllerHardware.canBusResetOnError.value())
+        std::array<uint8_t, packed::inpTgtLayout.size() * sizeof(int16_t)> data{};
+        for (size_t i = 0; i < packed::inpTgtLayout.size(); ++i)
         {
-            ESP_LOGW(TAG, "Something isn't right, trying to restart can ic...");
-            if (const auto err = twai_stop(); err != ESP_OK)
+            const auto &lane = packed::inpTgtLayout[i];
+            if (const Controller *controller = lane.isBack ? back : front)
             {
-                ESP_LOGE(TAG, "twai_stop() failed with %s", esp_err_to_name(err));
+                const auto &motor = lane.isRight ? controller->command.right : controller->command.left;
+                std::memcpy(data.data() + i * sizeof(int16_t), &(motor.*lane.member), sizeof(int16_t));
             }
-            if (configs.controllerHardware.canUninstallOnReset.value())
-            {
-                if (const auto err = twai_driver_uninstall(); err != ESP_OK)
-                {
-                    ESP_LOGE(TAG, "twai_driver_uninstall() failed with %s", esp_err_to_name(err));
-                }
-
-                constexpr twai_general_config_t g_config =
-                        TWAI_GENERAL_CONFIG_DEFAULT(GPIO_NUM_21, GPIO_NUM_22, TWAI_MODE_NORMAL);
-                constexpr twai_timing_config_t t_config = TWAI_TIMING_CONFIG_250KBITS();
-                constexpr twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+        }
+        ++sent;
 
-                if (const auto err = twai_driver_install(&g_config, &t_config, &f_config); err != ESP_OK)
-                {
-                    ESP_LOGE(TAG, "twai_driver_install() failed with %s", esp_err_to_name(err));
-                }
-            }
-            if (const auto err = twai_start(); err != ESP_OK)
-            {
-                ESP_LOGE(TAG, "twai_start() failed with %s", esp_err_to_name(err));
-            }
+        // a frame the driver did not take is due again on the next tick
+        if (sendFrame(packed::InpTgt, data.data(), data.size()) == ESP_OK)
+        {
+            if (front && packedBoards[0]) inpTgtSent(0, *front, now);
+            if (back && packedBoards[1]) inpTgtSent(1, *back, now);
         }
     }
-    return result;
-};
+#endif
 
-void sendCanCommands()
-{
-    using namespace config;
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        const Controller *controller = targets[i];
+        if (!controller) continue;
 
-    if (!configs.controllerHardware.sendFrontCanCmd.value() && !configs.controllerHardware.sendBackCanCmd.value())
-        return;
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+        if (usePacked && i < packedBoards.size() && packedBoards[i]) continue;
+#endif
 
-    const bool swap = configs.controllerHardware.swapFrontBack.value();
-    const Controller *front = (swap ? configs.controllerHardware.sendBackCanCmd.value()
-                                    : configs.controllerHardware.sendFrontCanCmd.value())
-                                      ? (swap ? &controllers.unswapped_back : &controllers.unswapped_front)
-                                      : nullptr;
-    const Controller *back = (swap ? configs.controllerHardware.sendFrontCanCmd.value()
-                                   : configs.controllerHardware.sendBackCanCmd.value())
-                                     ? (swap ? &controllers.unswapped_front : &controllers.unswapped_back)
-                                     : nullptr;
+        if (!inpTgtDue(i, *controller, now)) continue;
 
-    using namespace bobbycar::protocol::can;
+        const auto &identifiers = txschedule::inpTgtIdentifiers[i];
+        const bool leftSent = sendCommand(identifiers[0], controller->command.left.pwm) == ESP_OK;
+        const bool rightSent = sendCommand(identifiers[1], controller->command.right.pwm) == ESP_OK;
+        sent += 2;
 
-    if (front) sendCommand(MotorController<false, false>::Command::InpTgt, front->command.left.pwm);
-    if (front) sendCommand(MotorController<false, true>::Command::InpTgt, front->command.right.pwm);
-    if (back) sendCommand(MotorController<true, false>::Command::InpTgt, back->command.left.pwm);
-    if (back) sendCommand(MotorController<true, true>::Command::InpTgt, back->command.right.pwm);
+        if (leftSent && rightSent) inpTgtSent(i, *controller, now);
+    }
 
-    uint16_t buttonLeds{};
-    if (const auto index = configs.profileIndex.value())
+    if (sent)
     {
-        switch (index)
+        latency::mark(latency::Stage::TxEnqueue);
+        boot::mark(boot::Phase::FirstInpTgt);
+    }
+
+    // everything else: changed values first, then values whose refresh deadline expired
+    struct Candidate
+    {
+        uint8_t slot;
+        bool changed;
+        uint8_t priority;
+        espchrono::millis_clock::time_point lastSent;
+        uint32_t value;
+    };
+
+    std::array<Candidate, txschedule::slots.size()> candidates;
+    size_t candidateCount{0};
+
+    for (size_t i = 0; i < txschedule::slots.size(); ++i)
+    {
+        const auto &slot = txschedule::slots[i];
+        const auto &state = txSlotStates[i];
+
+        const Controller *controller{};
+        switch (slot.target)
         {
-            case 0:
-                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile0);
-                break;
-            case 1:
-                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile1);
-                break;
-            case 2:
-                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile2);
+            case txschedule::Target::Board:
+                controller = targets[slot.board];
+                if (!controller) continue;
                 break;
-            case 3:
-                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile3);
-                break;
-            default:
+            case txschedule::Target::Boardcomputer:
                 break;
         }
+
+        const auto value = slot.read(controller);
+        const bool changed = !state.sent || value != state.lastValue;
+
+        if (!changed && now - state.lastSent < slot.parameterClass.maxAge) continue;
+
+        candidates[candidateCount++] = {uint8_t(i), changed, slot.parameterClass.priority, state.lastSent, value};
     }
 
-    static struct
+    const auto budget = std::min(candidateCount, TX_FRAMES_PER_TICK > sent ? TX_FRAMES_PER_TICK - sent : 0);
+
+    const auto candidatesEnd = std::next(candidates.begin(), candidateCount);
+    std::partial_sort(candidates.begin(), std::next(candidates.begin(), budget), candidatesEnd,
+                      [](const Candidate &a, const Candidate &b) {
+                          return std::tie(b.changed, a.priority, a.lastSent) <
+                                 std::tie(a.changed, b.priority, b.lastSent);
+                      });
+
+    for (size_t i = 0; i < budget; ++i)
     {
-        struct
+        const auto &candidate = candidates[i];
+        const auto &slot = txschedule::slots[candidate.slot];
+
+        // failed frames stay changed or overdue and are retried on the next tick
+        if (sendFrame(slot.identifier, &candidate.value, slot.size) == ESP_OK)
         {
-            struct
-            {
-                int16_t nCruiseMotTgt{};
-                bool cruiseCtrlEna{};
-            } left, right;
-            uint8_t freq{};
-            uint8_t pattern{};
-        } front, back;
-        std::underlying_type_t<Boardcomputer::Button> buttonLeds{};
-    } lastValues;
-
-    static int i{};
-
-    // anti aufklatsch when tempomat
-    if ((front && front->command.left.nCruiseMotTgt != lastValues.front.left.nCruiseMotTgt) ||
-        (front && front->command.right.nCruiseMotTgt != lastValues.front.right.nCruiseMotTgt) ||
-        (back && back->command.left.nCruiseMotTgt != lastValues.back.left.nCruiseMotTgt) ||
-        (back && back->command.right.nCruiseMotTgt != lastValues.back.right.nCruiseMotTgt))
-        i = 8;
-    else if ((front && front->command.left.cruiseCtrlEna != lastValues.front.left.cruiseCtrlEna) ||
-             (front && front->command.right.cruiseCtrlEna != lastValues.front.right.cruiseCtrlEna) ||
-             (back && back->command.left.cruiseCtrlEna != lastValues.back.left.cruiseCtrlEna) ||
-             (back && back->command.right.cruiseCtrlEna != lastValues.back.right.cruiseCtrlEna))
-        i = 9;
-    else if ((front && front->command.buzzer.freq != lastValues.front.freq) ||
-             (front && front->command.buzzer.pattern != lastValues.front.pattern) ||
-             (back && back->command.buzzer.freq != lastValues.back.freq) ||
-             (back && back->command.buzzer.pattern != lastValues.back.pattern))
-        i = 10;
-    else if (buttonLeds != lastValues.buttonLeds)
-        i = 12;
-
-    switch (i++)
-    {
-        case 0: {
-            if (front) sendCommand(MotorController<false, false>::Command::Enable, front->command.left.enable);
-            if (front) sendCommand(MotorController<false, true>::Command::Enable, front->command.right.enable);
-            if (back) sendCommand(MotorController<true, false>::Command::Enable, back->command.left.enable);
-            if (back) sendCommand(MotorController<true, true>::Command::Enable, back->command.right.enable);
-            break;
+            auto &state = txSlotStates[candidate.slot];
+            state.lastValue = candidate.value;
+            state.lastSent = now;
+            state.sent = true;
         }
-        case 1: {
-            if (front) sendCommand(MotorController<false, false>::Command::CtrlTyp, front->command.left.ctrlTyp);
-            if (front) sendCommand(MotorController<false, true>::Command::CtrlTyp, front->command.right.ctrlTyp);
-            if (back) sendCommand(MotorController<true, false>::Command::CtrlTyp, back->command.left.ctrlTyp);
-            if (back) sendCommand(MotorController<true, true>::Command::CtrlTyp, back->command.right.ctrlTyp);
-            break;
-        }
-        case 2: {
-            if (front) sendCommand(MotorController<false, false>::Command::CtrlMod, front->command.left.ctrlMod);
-            if (front) sendCommand(MotorController<false, true>::Command::CtrlMod, front->command.right.ctrlMod);
-            if (back) sendCommand(MotorController<true, false>::Command::CtrlMod, back->command.left.ctrlMod);
-            if (back) sendCommand(MotorController<true, true>::Command::CtrlMod, back->command.right.ctrlMod);
-            // handbremse::finishedMotorUpdate = true;
-            break;
-        }
-        case 3: {
-            if (front) sendCommand(MotorController<false, false>::Command::IMotMax, front->command.left.iMotMax);
-            if (front) sendCommand(MotorController<false, true>::Command::IMotMax, front->command.right.iMotMax);
-            if (back) sendCommand(MotorController<true, false>::Command::IMotMax, back->command.left.iMotMax);
-            if (back) sendCommand(MotorController<true, true>::Command::IMotMax, back->command.right.iMotMax);
-            break;
-        }
-        case 4: {
-            if (front) sendCommand(MotorController<false, false>::Command::IDcMax, front->command.left.iDcMax);
-            if (front) sendCommand(MotorController<false, true>::Command::IDcMax, front->command.right.iDcMax);
-            if (back) sendCommand(MotorController<true, false>::Command::IDcMax, back->command.left.iDcMax);
-            if (back) sendCommand(MotorController<true, true>::Command::IDcMax, back->command.right.iDcMax);
-            break;
-        }
-        case 5: {
-            if (front) sendCommand(MotorController<false, false>::Command::NMotMax, front->command.left.nMotMax);
-            if (front) sendCommand(MotorController<false, true>::Command::NMotMax, front->command.right.nMotMax);
-            if (back) sendCommand(MotorController<true, false>::Command::NMotMax, back->command.left.nMotMax);
-            if (back) sendCommand(MotorController<true, true>::Command::NMotMax, back->command.right.nMotMax);
-            break;
-        }
-        case 6: {
-            if (front)
-                sendCommand(MotorController<false, false>::Command::FieldWeakMax, front->command.left.fieldWeakMax);
-            if (front)
-                sendCommand(MotorController<false, true>::Command::FieldWeakMax, front->command.right.fieldWeakMax);
-            if (back) sendCommand(MotorController<true, false>::Command::FieldWeakMax, back->command.left.fieldWeakMax);
-            if (back) sendCommand(MotorController<true, true>::Command::FieldWeakMax, back->command.right.fieldWeakMax);
-            break;
-        }
-        case 7: {
-            if (front)
-                sendCommand(MotorController<false, false>::Command::PhaseAdvMax, front->command.left.phaseAdvMax);
-            if (front)
-                sendCommand(MotorController<false, true>::Command::PhaseAdvMax, front->command.right.phaseAdvMax);
-            if (back) sendCommand(MotorController<true, false>::Command::PhaseAdvMax, back->command.left.phaseAdvMax);
-            if (back) sendCommand(MotorController<true, true>::Command::PhaseAdvMax, back->command.right.phaseAdvMax);
-            break;
-        }
-        case 8: {
-            if (front)
-                sendCommand(MotorController<false, false>::Command::CruiseMotTgt, front->command.left.nCruiseMotTgt);
-            if (front)
-                sendCommand(MotorController<false, true>::Command::CruiseMotTgt, front->command.right.nCruiseMotTgt);
-            if (back)
-                sendCommand(MotorController<true, false>::Command::CruiseMotTgt, back->command.left.nCruiseMotTgt);
-            if (back)
-                sendCommand(MotorController<true, true>::Command::CruiseMotTgt, back->command.right.nCruiseMotTgt);
-            break;
-        }
-        case 9: {
-            if (front)
-                sendCommand(MotorController<false, false>::Command::CruiseCtrlEna, front->command.left.cruiseCtrlEna);
-            if (front)
-                sendCommand(MotorController<false, true>::Command::CruiseCtrlEna, front->command.right.cruiseCtrlEna);
-            if (back)
-                sendCommand(MotorController<true, false>::Command::CruiseCtrlEna, back->command.left.cruiseCtrlEna);
-            if (back)
-                sendCommand(MotorController<true, true>::Command::CruiseCtrlEna, back->command.right.cruiseCtrlEna);
-            break;
-        }
-        case 10: {
-            if (front &&
-                sendCommand(MotorController<false, false>::Command::BuzzerFreq, front->command.buzzer.freq) == ESP_OK)
-                lastValues.front.freq = front->command.buzzer.freq;
-            if (back &&
-                sendCommand(MotorController<true, false>::Command::BuzzerFreq, back->command.buzzer.freq) == ESP_OK)
-                lastValues.back.freq = back->command.buzzer.freq;
-            if (front && sendCommand(MotorController<false, false>::Command::BuzzerPattern,
-                                     front->command.buzzer.pattern) == ESP_OK)
-                lastValues.front.pattern = front->command.buzzer.pattern;
-            if (back && sendCommand(MotorController<true, false>::Command::BuzzerPattern,
-                                    back->command.buzzer.pattern) == ESP_OK)
-                lastValues.back.pattern = back->command.buzzer.pattern;
-            return;
-        }
-        case 11: {
-            if (front) sendCommand(MotorController<false, false>::Command::Led, front->command.led);
-            if (back) sendCommand(MotorController<true, false>::Command::Led, back->command.led);
-            if (front) sendCommand(MotorController<false, false>::Command::Poweroff, front->command.poweroff);
-            if (back) sendCommand(MotorController<true, false>::Command::Poweroff, back->command.poweroff);
-            return;
-        }
-        case 12:
-            if (sendCommand(Boardcomputer::Feedback::ButtonLeds, buttonLeds) == ESP_OK)
-                lastValues.buttonLeds = buttonLeds;
-        [[fallthrough]];
-        default:
-            i = 0;
-            break;
     }
 }
 
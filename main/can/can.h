@@ -15,6 +15,10 @@ namespace inputs {
 
     extern std::atomic<std::optional<float>> gas;
     extern std::atomic<std::optional<float>> brems;
+
+    // hands the pedal values received via CAN to the driving modes, gas and brems are clamped to 0..1000.
+    // Everything is empty while remote control is not allowed or the last value timed out.
+    void update(bool allowRemoteControl);
 } // namespace inputs
 
 namespace outputs {
@@ -37,8 +41,49 @@ namespace can_external {
 
     extern const std::atomic<espchrono::millis_clock::time_point> &lastCanGas;
     extern const std::atomic<espchrono::millis_clock::time_point> &lastCanBrems;
+
+    // canGas/canBrems, empty if not received within CONFIG_BOBBYCAR_CAN_EXTERNAL_INPUT_TIMEOUT_MS
+    std::optional<int16_t> freshGas();
+    std::optional<int16_t> freshBrems();
+
+    struct ButtonEvent
+    {
+        enum class Type : uint8_t
+        {
+            RawPressed,
+            RawReleased,
+            Pressed,
+            Released
+        };
+
+        Type type;
+        uint8_t button; // raw button index for the Raw types, espgui::Button otherwise
+    };
+
+    // button events received via CAN, there must only be one consumer
+    bool popButtonEvent(ButtonEvent &event);
+
+    // button events lost because the consumer did not keep up
+    extern const std::atomic<uint32_t> &droppedButtonEvents;
 } // namespace can_external
 
+namespace stats {
+    // frames decoded by the last updateCan() call
+    extern const std::atomic<uint32_t> &rxDrained;
+    // frames still queued in the driver after the last updateCan() call
+    extern const std::atomic<uint32_t> &rxLeftBehind;
+    // frames lost because the RX task ring was full (CONFIG_BOBBYCAR_CAN_RX_TASK only)
+    extern const std::atomic<uint32_t> &rxRingDropped;
+    // worst time a frame waited in the RX task ring before being decoded (CONFIG_BOBBYCAR_CAN_RX_TASK only)
+    extern const std::atomic<int64_t> &rxRingMaxLatencyUs;
+    // bus off recoveries and driver restarts since boot
+    extern const std::atomic<uint32_t> &busRecoveries;
+    // total time spent recovering since boot
+    extern const std::atomic<uint32_t> &busRecoveryTimeMs;
+    // duration of the last completed recovery
+    extern const std::atomic<uint32_t> &lastBusRecoveryMs;
+} // namespace stats
+
 extern bool can_initialized;
 
 // initialize the CAN bus
@@ -47,6 +92,11 @@ void initCan();
 // update the state and read the CAN bus
 void updateCan();
 
+// the receive half of updateCan(): decodes one frame, false if none arrived within canReceiveTimeout
+bool tryParseCanInput();
+// the receive half of updateCan() with CONFIG_BOBBYCAR_CAN_RX_DRAIN: decodes the queued frames within the drain budget
+void drainCanInput();
+
 // send commands to the motor controllers (usually done after updating the driving model)
 void sendCanCommands();
 } // namespace can
@@ -0,0 +1,40 @@
+#pragma once
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// system includes
+#include <array>
+#include <cstdint>
+#include <utility>
+
+// 3rdparty lib includes
+#include <bobbycar-can.h>
+
+struct Controller;
+
+// Motor board index -> CAN identifier mapping. Board 0 is the front and board 1 the back board, both use the
+// bobbycar-protocol identifiers unchanged. Every further pair of boards reuses them shifted by
+// CONFIG_BOBBYCAR_CAN_BOARD_ID_STRIDE, even boards look like a front board, odd ones like a back board.
+namespace can::boards {
+
+constexpr uint8_t COUNT = CONFIG_BOBBYCAR_MOTOR_BOARD_COUNT;
+static_assert(COUNT >= 2, "there is always a front and a back board");
+
+constexpr uint32_t STRIDE = CONFIG_BOBBYCAR_CAN_BOARD_ID_STRIDE;
+
+constexpr auto indices = std::make_integer_sequence<uint8_t, COUNT>{};
+
+template<uint8_t board, bool isRight>
+using MotorController = bobbycar::protocol::can::MotorController<board % 2 == 1, isRight>;
+
+// protocolIdentifier is one of the MotorController<board % 2 == 1, isRight> identifiers
+constexpr uint32_t identifier(const uint8_t board, const uint32_t protocolIdentifier)
+{
+    return protocolIdentifier + board / 2 * STRIDE;
+}
+
+// controller of every board index with swapFrontBack applied
+using Resolved = std::array<Controller *, COUNT>;
+
+} // namespace can::boards
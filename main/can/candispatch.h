@@ -0,0 +1,235 @@
+#pragma once
+
+// system includes
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// esp-idf includes
+#include <driver/twai.h>
+
+// 3rdparty lib includes
+#include <bobbycar-can.h>
+
+// local includes
+#include "canboards.h"
+#include "driving_modes/controllers.h"
+#include "driving_modes/motorlanes.h"
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+#include "canpacked.h"
+#endif
+#include "utils/arrayutils.h"
+
+namespace can::dispatch {
+
+enum class Target : uint8_t
+{
+    None,
+    Board,
+    Boardcomputer
+};
+
+// controller is nullptr for Target::Boardcomputer
+using Decoder = void (*)(const twai_message_t &message, Controller *controller);
+
+struct Route
+{
+    Target target{Target::None};
+    uint8_t board{}; // motor board index for Target::Board
+    Decoder decode{};
+    bool speed{}; // carries a speed lane, can::outputs derives the acceleration from these frames only
+};
+
+struct Entry
+{
+    uint32_t identifier;
+    Route route;
+};
+
+namespace detail {
+    template<typename T>
+    T read(const twai_message_t &message)
+    {
+        T value;
+        std::memcpy(&value, message.data, sizeof(value));
+        return value;
+    }
+
+    template<bool isRight, auto Member>
+    void decodeMotor(const twai_message_t &message, Controller *controller)
+    {
+        auto &motor = isRight ? controller->feedback.right : controller->feedback.left;
+        motor.*Member = read<std::remove_cvref_t<decltype(motor.*Member)>>(message);
+    }
+
+    // lane quantities also go straight into motorlanes::feedback
+    template<uint8_t board, bool isRight, auto Member, auto Lane>
+    void decodeLane(const twai_message_t &message, Controller *controller)
+    {
+        auto &motor = isRight ? controller->feedback.right : controller->feedback.left;
+        motor.*Member = read<std::remove_cvref_t<decltype(motor.*Member)>>(message);
+        (motorlanes::feedback.*Lane)[motorlanes::index(board, isRight)] = motor.*Member;
+    }
+
+    template<bool isRight>
+    void decodeHall(const twai_message_t &message, Controller *controller)
+    {
+        auto &motor = isRight ? controller->feedback.right : controller->feedback.left;
+        const auto hall = read<uint8_t>(message);
+        motor.hallA = hall & 1;
+        motor.hallB = hall & 2;
+        motor.hallC = hall & 4;
+    }
+
+    template<auto Member>
+    void decodeBoard(const twai_message_t &message, Controller *controller)
+    {
+        auto &feedback = controller->feedback;
+        feedback.*Member = read<std::remove_cvref_t<decltype(feedback.*Member)>>(message);
+    }
+
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+    template<uint8_t board, const auto &Layout>
+    void decodePacked(const twai_message_t &message, Controller *controller)
+    {
+        for (size_t i = 0; i < Layout.size(); ++i)
+        {
+            const auto &lane = Layout[i];
+            auto &motor = lane.isRight ? controller->feedback.right : controller->feedback.left;
+            std::memcpy(&(motor.*lane.member), message.data + i * sizeof(int16_t), sizeof(int16_t));
+        }
+        motorlanes::store(board, controller->feedback);
+
+        // a board that sends packed feedback also understands packed commands
+        controller->lastPackedFeedback = espchrono::millis_clock::now();
+    }
+
+    template<bool isBack>
+    constexpr std::array<Entry, 2> packedEntries()
+    {
+        using Ids = packed::Feedback<isBack>;
+
+        // packed frames only exist for the front and back board
+        constexpr uint8_t board = isBack ? 1 : 0;
+
+        return {{
+                {Ids::SpeedDcLink, {Target::Board, board, decodePacked<board, packed::speedDcLinkLayout>, true}},
+                {Ids::IqId, {Target::Board, board, decodePacked<board, packed::iqIdLayout>}},
+        }};
+    }
+#else
+    template<bool isBack>
+    constexpr std::array<Entry, 0> packedEntries()
+    {
+        return {};
+    }
+#endif
+
+    // Boardcomputer inputs, defined in canexternal.cpp
+    void decodeRawButtonPressed(const twai_message_t &message, Controller *);
+    void decodeRawButtonReleased(const twai_message_t &message, Controller *);
+    void decodeButtonPressed(const twai_message_t &message, Controller *);
+    void decodeButtonReleased(const twai_message_t &message, Controller *);
+    void decodeRawGas(const twai_message_t &message, Controller *);
+    void decodeRawBrems(const twai_message_t &message, Controller *);
+
+    template<uint8_t board, bool isRight>
+    constexpr std::array<Entry, 13> motorControllerEntries()
+    {
+        using bobbycar::protocol::serial::Feedback;
+        using bobbycar::protocol::serial::MotorFeedback;
+        using Ids = typename boards::MotorController<board, isRight>::Feedback;
+        using Lanes = motorlanes::Feedback;
+
+        const auto entry = [](const uint32_t identifier, const Decoder decode, const bool speed = false) -> Entry {
+            return {boards::identifier(board, identifier), {Target::Board, board, decode, speed}};
+        };
+
+        return {{
+                entry(Ids::DcLink, decodeLane<board, isRight, &MotorFeedback::dcLink, &Lanes::dcLink>),
+                entry(Ids::Speed, decodeLane<board, isRight, &MotorFeedback::speed, &Lanes::speed>, true),
+                entry(Ids::Error, decodeMotor<isRight, &MotorFeedback::error>),
+                entry(Ids::Angle, decodeMotor<isRight, &MotorFeedback::angle>),
+                entry(Ids::DcPhaA, decodeMotor<isRight, &MotorFeedback::dcPhaA>),
+                entry(Ids::DcPhaB, decodeMotor<isRight, &MotorFeedback::dcPhaB>),
+                entry(Ids::DcPhaC, decodeMotor<isRight, &MotorFeedback::dcPhaC>),
+                entry(Ids::Chops, decodeMotor<isRight, &MotorFeedback::chops>),
+                entry(Ids::Hall, decodeHall<isRight>),
+                entry(Ids::Voltage, decodeBoard<&Feedback::batVoltage>),
+                entry(Ids::Temp, decodeBoard<&Feedback::boardTemp>),
+                entry(Ids::Id, decodeLane<board, isRight, &MotorFeedback::id, &Lanes::id>),
+                entry(Ids::Iq, decodeLane<board, isRight, &MotorFeedback::iq, &Lanes::iq>),
+        }};
+    }
+
+    template<uint8_t... board>
+    constexpr auto motorControllerEntries(std::integer_sequence<uint8_t, board...>)
+    {
+        return arrayutils::concat(motorControllerEntries<board, false>()..., motorControllerEntries<board, true>()...);
+    }
+
+    constexpr std::array<Entry, 6> boardcomputerEntries()
+    {
+        using Ids = bobbycar::protocol::can::Boardcomputer::Command;
+
+        constexpr auto target = Target::Boardcomputer;
+
+        return {{
+                {Ids::RawButtonPressed, {target, 0, decodeRawButtonPressed}},
+                {Ids::RawButtonReleased, {target, 0, decodeRawButtonReleased}},
+                {Ids::ButtonPressed, {target, 0, decodeButtonPressed}},
+                {Ids::ButtonReleased, {target, 0, decodeButtonReleased}},
+                {Ids::RawGas, {target, 0, decodeRawGas}},
+                {Ids::RawBrems, {target, 0, decodeRawBrems}},
+        }};
+    }
+} // namespace detail
+
+// every identifier we know how to decode
+constexpr auto entries =
+        arrayutils::concat(detail::motorControllerEntries(boards::indices), detail::boardcomputerEntries(),
+                           detail::packedEntries<false>(), detail::packedEntries<true>());
+
+constexpr uint32_t minIdentifier = std::ranges::min(entries, {}, &Entry::identifier).identifier;
+constexpr uint32_t maxIdentifier = std::ranges::max(entries, {}, &Entry::identifier).identifier;
+constexpr size_t span = maxIdentifier - minIdentifier + 1;
+
+static_assert(maxIdentifier <= 0x7FF, "dispatch table only covers standard 11 bit identifiers");
+static_assert(entries.size() < 0xFF, "route index has to fit into uint8_t");
+static_assert(
+        [] {
+            auto identifiers = entries;
+            std::ranges::sort(identifiers, {}, &Entry::identifier);
+            return std::ranges::adjacent_find(identifiers, {}, &Entry::identifier) == identifiers.end();
+        }(),
+        "duplicate CAN identifier in dispatch table");
+
+// slot 0 is the "unknown identifier" route
+constexpr auto routes = [] {
+    std::array<Route, entries.size() + 1> result{};
+    for (size_t i = 0; i < entries.size(); ++i) result[i + 1] = entries[i].route;
+    return result;
+}();
+
+// dense identifier -> route index table, built at compile time
+constexpr auto index = [] {
+    std::array<uint8_t, span> result{};
+    for (size_t i = 0; i < entries.size(); ++i) result[entries[i].identifier - minIdentifier] = i + 1;
+    return result;
+}();
+
+constexpr const Route &lookup(const uint32_t identifier)
+{
+    // identifiers below minIdentifier wrap around and fail the range check
+    const uint32_t offset = identifier - minIdentifier;
+    return routes[offset < span ? index[offset] : 0];
+}
+
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+static_assert(lookup(packed::InpTgt).target == Target::None, "packed InpTgt collides with a feedback identifier");
+#endif
+
+} // namespace can::dispatch
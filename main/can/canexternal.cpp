@@ -0,0 +1,144 @@
+#include "can.h"
+
+// values and button events sent to the boardcomputer by other CAN nodes, e.g. remote pedal modules
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// system includes
+#include <algorithm>
+#include <atomic>
+#include <optional>
+
+// 3rdparty lib includes
+#include <espchrono.h>
+
+// local includes
+#include "candispatch.h"
+#include "utils/latencytrace.h"
+#include "utils/spscring.h"
+
+namespace can {
+
+namespace can_external {
+    // variables that can be read in from other modules via CAN
+    std::atomic<std::optional<int16_t>> _canGas;
+    const std::atomic<std::optional<int16_t>> &canGas{_canGas};
+
+    std::atomic<std::optional<int16_t>> _canBrems;
+    const std::atomic<std::optional<int16_t>> &canBrems{_canBrems};
+
+    std::atomic<espchrono::millis_clock::time_point> _lastCanGas;
+    const std::atomic<espchrono::millis_clock::time_point> &lastCanGas{_lastCanGas};
+
+    std::atomic<espchrono::millis_clock::time_point> _lastCanBrems;
+    const std::atomic<espchrono::millis_clock::time_point> &lastCanBrems{_lastCanBrems};
+
+    std::atomic<uint32_t> _droppedButtonEvents;
+    const std::atomic<uint32_t> &droppedButtonEvents{_droppedButtonEvents};
+
+    namespace {
+        using namespace std::chrono_literals;
+
+        constexpr auto INPUT_TIMEOUT = CONFIG_BOBBYCAR_CAN_EXTERNAL_INPUT_TIMEOUT_MS * 1ms;
+
+        // produced by the CAN task only
+        SpscRing<ButtonEvent, 16> buttonEvents;
+
+        // value first, timestamp last, so a fresh timestamp never pairs with an older value
+        void store(std::atomic<std::optional<int16_t>> &value,
+                   std::atomic<espchrono::millis_clock::time_point> &timestamp, const int16_t received)
+        {
+            value.store(received, std::memory_order_relaxed);
+            timestamp.store(espchrono::millis_clock::now(), std::memory_order_release);
+        }
+
+        std::optional<int16_t> fresh(const std::atomic<std::optional<int16_t>> &value,
+                                     const std::atomic<espchrono::millis_clock::time_point> &timestamp)
+        {
+            if (espchrono::millis_clock::now() - timestamp.load(std::memory_order_acquire) > INPUT_TIMEOUT)
+                return std::nullopt;
+            return value.load(std::memory_order_relaxed);
+        }
+
+        void pushButtonEvent(const ButtonEvent::Type type, const twai_message_t &message)
+        {
+            if (!buttonEvents.push({type, dispatch::detail::read<uint8_t>(message)}))
+                _droppedButtonEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    } // namespace
+
+    std::optional<int16_t> freshGas()
+    {
+        return fresh(_canGas, _lastCanGas);
+    }
+
+    std::optional<int16_t> freshBrems()
+    {
+        return fresh(_canBrems, _lastCanBrems);
+    }
+
+    bool popButtonEvent(ButtonEvent &event)
+    {
+        return buttonEvents.pop(event);
+    }
+} // namespace can_external
+
+namespace inputs {
+    namespace {
+        std::optional<float> pedal(const std::optional<int16_t> raw)
+        {
+            if (!raw) return std::nullopt;
+            return std::clamp<float>(*raw, 0.f, 1000.f);
+        }
+    } // namespace
+
+    void update(const bool allowRemoteControl)
+    {
+        const auto gasValue = allowRemoteControl ? can_external::freshGas() : std::nullopt;
+        const auto bremsValue = allowRemoteControl ? can_external::freshBrems() : std::nullopt;
+
+        rawGas.store(gasValue, std::memory_order_relaxed);
+        rawBrems.store(bremsValue, std::memory_order_relaxed);
+        gas.store(pedal(gasValue), std::memory_order_relaxed);
+        brems.store(pedal(bremsValue), std::memory_order_relaxed);
+
+        if (gasValue) latency::mark(latency::Stage::InputHandOff);
+    }
+} // namespace inputs
+
+namespace dispatch::detail {
+    void decodeRawButtonPressed(const twai_message_t &message, Controller *)
+    {
+        can_external::pushButtonEvent(can_external::ButtonEvent::Type::RawPressed, message);
+    }
+
+    void decodeRawButtonReleased(const twai_message_t &message, Controller *)
+    {
+        can_external::pushButtonEvent(can_external::ButtonEvent::Type::RawReleased, message);
+    }
+
+    void decodeButtonPressed(const twai_message_t &message, Controller *)
+    {
+        can_external::pushButtonEvent(can_external::ButtonEvent::Type::Pressed, message);
+    }
+
+    void decodeButtonReleased(const twai_message_t &message, Controller *)
+    {
+        can_external::pushButtonEvent(can_external::ButtonEvent::Type::Released, message);
+    }
+
+    void decodeRawGas(const twai_message_t &message, Controller *)
+    {
+        const auto value = read<int16_t>(message);
+        can_external::store(can_external::_canGas, can_external::_lastCanGas, value);
+        latency::inputSampled(value);
+    }
+
+    void decodeRawBrems(const twai_message_t &message, Controller *)
+    {
+        can_external::store(can_external::_canBrems, can_external::_lastCanBrems, read<int16_t>(message));
+    }
+} // namespace dispatch::detail
+
+} // namespace can
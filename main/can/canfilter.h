@@ -0,0 +1,135 @@
+#pragma once
+
+// system includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// esp-idf includes
+#include <driver/twai.h>
+
+// local includes
+#include "candispatch.h"
+
+// TWAI acceptance filter generated from the identifiers in the dispatch table
+namespace can::filter {
+
+// set of 11 bit identifiers matching code on every bit that is 0 in mask
+struct Cube
+{
+    uint32_t code;
+    uint32_t mask;
+};
+
+struct Choice
+{
+    Cube first;
+    Cube second;
+    bool dual;
+    uint32_t accepted; // identifiers the hardware lets through
+};
+
+namespace detail {
+    constexpr auto identifiers = [] {
+        std::array<uint32_t, dispatch::entries.size()> result{};
+        std::ranges::transform(dispatch::entries, result.begin(), &dispatch::Entry::identifier);
+        std::ranges::sort(result);
+        return result;
+    }();
+
+    constexpr uint32_t size(const Cube cube)
+    {
+        return uint32_t{1} << std::popcount(cube.mask);
+    }
+
+    constexpr bool accepts(const Cube cube, const uint32_t identifier)
+    {
+        return ((identifier ^ cube.code) & ~cube.mask & 0x7FF) == 0;
+    }
+
+    constexpr uint32_t unionSize(const Cube a, const Cube b)
+    {
+        const bool overlap = ((a.code ^ b.code) & ~a.mask & ~b.mask & 0x7FF) == 0;
+        return size(a) + size(b) - (overlap ? uint32_t{1} << std::popcount(a.mask & b.mask) : 0);
+    }
+
+    // smallest cube containing every identifier the predicate selects
+    constexpr Cube cover(auto &&predicate)
+    {
+        Cube cube{0, 0};
+        bool first{true};
+        for (const auto identifier: identifiers)
+        {
+            if (!predicate(identifier)) continue;
+            if (first)
+            {
+                cube.code = identifier;
+                first = false;
+            }
+            cube.mask |= identifier ^ cube.code;
+        }
+        cube.code &= ~cube.mask;
+        return cube;
+    }
+
+    constexpr Choice choose()
+    {
+        const auto all = cover([](uint32_t) { return true; });
+        Choice best{all, all, false, size(all)};
+
+        const auto consider = [&best](auto &&inFirst) {
+            const auto notInFirst = [&inFirst](const uint32_t identifier) { return !inFirst(identifier); };
+            if (std::ranges::all_of(identifiers, inFirst) || std::ranges::none_of(identifiers, inFirst)) return;
+
+            const auto first = cover(inFirst);
+            const auto second = cover(notInFirst);
+            if (const auto accepted = unionSize(first, second); accepted < best.accepted)
+                best = {first, second, true, accepted};
+        };
+
+        // split on every identifier bit
+        for (uint32_t bit = 0; bit < 11; ++bit)
+            consider([bit](const uint32_t identifier) { return (identifier >> bit) & 1; });
+
+        // split the sorted identifiers at every position
+        for (const auto pivot: identifiers)
+            consider([pivot](const uint32_t identifier) { return identifier < pivot; });
+
+        return best;
+    }
+} // namespace detail
+
+constexpr Choice choice = detail::choose();
+
+// see "Acceptance Filter" in the TWAI driver documentation for the bit layout of standard frame filters
+constexpr twai_filter_config_t filterConfig = [] {
+    twai_filter_config_t result{};
+    if (choice.dual)
+    {
+        // filter 1: ID in [31:21], RTR and first data byte don't care; filter 2: ID in [15:5], RTR don't care
+        result.acceptance_code = (choice.first.code << 21) | (choice.second.code << 5);
+        result.acceptance_mask = (choice.first.mask << 21) | (choice.second.mask << 5) | 0x001F001F;
+        result.single_filter = false;
+    }
+    else
+    {
+        // ID in [31:21], RTR and both data bytes don't care
+        result.acceptance_code = choice.first.code << 21;
+        result.acceptance_mask = (choice.first.mask << 21) | 0x001FFFFF;
+        result.single_filter = true;
+    }
+    return result;
+}();
+
+// identifiers that pass the hardware filter but are not decoded
+constexpr uint32_t foreignIdentifiers = choice.accepted - detail::identifiers.size();
+
+static_assert(std::ranges::all_of(detail::identifiers,
+                                  [](const uint32_t identifier) {
+                                      return detail::accepts(choice.first, identifier) ||
+                                             (choice.dual && detail::accepts(choice.second, identifier));
+                                  }),
+              "acceptance filter drops an identifier from the dispatch table");
+
+} // namespace can::filter
@@ -0,0 +1,102 @@
+#include "canoutputs.h"
+
+// system includes
+#include <atomic>
+#include <cstddef>
+
+// local includes
+#include "can.h"
+#include "canoutputskernel.h"
+#include "config/configsnapshot.h"
+
+namespace can::outputs {
+
+// value from motor controller in RPM
+std::atomic<float> _averageSpeed;
+const std::atomic<float> &averageSpeed{_averageSpeed};
+
+// converted value from average_speed in km/h
+std::atomic<float> _averageSpeedKmh;
+const std::atomic<float> &averageSpeedKmh{_averageSpeedKmh};
+
+// average acceleration in m/s^2
+std::atomic<float> _averageAcceleration;
+const std::atomic<float> &averageAcceleration{_averageAcceleration};
+
+// total current in A
+std::atomic<float> _totalCurrent;
+const std::atomic<float> &totalCurrent{_totalCurrent};
+
+namespace {
+    // time constant of the low pass on the speed derivative, averageAcceleration lags by about this much
+    constexpr float ACCELERATION_FILTER_TIME_S = 0.1f;
+
+    // dcLink is reported in 1/50 A, positive while braking
+    constexpr float DC_LINK_TO_AMPERE = -1.f / 50.f;
+
+    // derived from the config snapshot whenever it changes
+    struct Factors
+    {
+        float rpmToKmh;
+        motorlanes::Lane<float> speedSign;
+    };
+
+    uint32_t snapshotGeneration{};
+    Factors factors{};
+
+    Acceleration acceleration;
+
+    Factors makeFactors(const config::Snapshot &snapshot)
+    {
+        return {
+                .rpmToKmh = rpmToKmh(snapshot.controllerHardware.wheelDiameter),
+                .speedSign = motorlanes::wheels(snapshot.profile).sign,
+        };
+    }
+} // namespace
+
+void update(const motorlanes::Feedback &lanes, const int64_t speedTimestamp)
+{
+    if (config::Snapshot snapshot; config::snapshot.generation() != snapshotGeneration)
+    {
+        snapshotGeneration = config::snapshot.read(snapshot);
+        factors = makeFactors(snapshot);
+    }
+
+    // branch free over every wheel, invalid boards are masked out
+    float speedSum{};
+    float current{};
+    uint8_t motors{};
+
+    for (size_t i = 0; i < motorlanes::COUNT; ++i)
+    {
+        const float valid = lanes.valid[i];
+        speedSum += valid * factors.speedSign[i] * lanes.speed[i];
+        current += valid * lanes.dcLink[i];
+        motors += lanes.valid[i];
+    }
+
+    current *= DC_LINK_TO_AMPERE;
+
+    if (!motors)
+    {
+        acceleration.valid = false;
+        _averageSpeed = 0.f;
+        _averageSpeedKmh = 0.f;
+        _averageAcceleration = 0.f;
+        _totalCurrent = 0.f;
+        return;
+    }
+
+    const float speed = speedSum / motors;
+    const float speedKmh = speed * factors.rpmToKmh;
+
+    updateAcceleration(acceleration, speedKmh, speedTimestamp, ACCELERATION_FILTER_TIME_S);
+
+    _averageSpeed = speed;
+    _averageSpeedKmh = speedKmh;
+    _averageAcceleration = acceleration.value;
+    _totalCurrent = current;
+}
+
+} // namespace can::outputs
@@ -0,0 +1,16 @@
+#pragma once
+
+// system includes
+#include <cstdint>
+
+// local includes
+#include "driving_modes/motorlanes.h"
+
+// keeps can::outputs up to date, only called by the task that decodes feedback
+namespace can::outputs {
+
+// recomputes every output from the wheels with valid feedback. speedTimestamp is esp_timer_get_time() of the newest
+// frame that carried a speed lane, the acceleration only moves when it changed.
+void update(const motorlanes::Feedback &lanes, int64_t speedTimestamp);
+
+} // namespace can::outputs
@@ -0,0 +1,51 @@
+#pragma once
+
+// system includes
+#include <cstdint>
+#include <numbers>
+
+// Unit conversions and the acceleration filter of can::outputs. Free of config and hardware access, so they can be
+// run with recorded feedback.
+namespace can::outputs {
+
+// the motor controllers already report the wheel rpm, so the pole count does not show up here
+constexpr float rpmToKmh(const float wheelDiameterMm)
+{
+    return wheelDiameterMm / 1000.f * std::numbers::pi_v<float> * 60.f / 1000.f;
+}
+
+// low passed derivative of the average speed
+struct Acceleration
+{
+    bool valid{false};
+    float speed{}; // m/s
+    int64_t timestamp{};
+    float value{}; // m/s^2
+};
+
+// timestamp is esp_timer_get_time() of the speed frame the sample comes from. Only a newer speed frame moves the
+// derivative, feeding the same speed again with a later timestamp would drag it towards zero.
+inline void updateAcceleration(Acceleration &state, const float speedKmh, const int64_t timestamp,
+                               const float filterTimeS)
+{
+    if (state.valid && timestamp == state.timestamp) return;
+
+    const float speed = speedKmh / 3.6f;
+
+    if (state.valid && timestamp > state.timestamp)
+    {
+        const float dt = (timestamp - state.timestamp) / 1000000.f;
+        const float raw = (speed - state.speed) / dt;
+        state.value += dt / (filterTimeS + dt) * (raw - state.value);
+    }
+    else
+    {
+        state.value = 0.f;
+    }
+
+    state.valid = true;
+    state.speed = speed;
+    state.timestamp = timestamp;
+}
+
+} // namespace can::outputs
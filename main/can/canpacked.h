@@ -0,0 +1,78 @@
+#pragma once
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// system includes
+#include <array>
+#include <cstdint>
+
+// 3rdparty lib includes
+#include <bobbycar-serial.h>
+
+// Packed frame layouts, kept in sync with the motor controller firmware until they move into bobbycar-protocol.
+// Every lane is a little endian int16 at byte offset 2 * lane index.
+namespace can::packed {
+
+using bobbycar::protocol::serial::MotorFeedback;
+using bobbycar::protocol::serial::MotorState;
+
+enum : uint16_t
+{
+    InpTgt = CONFIG_BOBBYCAR_CAN_PACKED_ID_BASE,
+    FrontSpeedDcLink,
+    FrontIqId,
+    BackSpeedDcLink,
+    BackIqId,
+};
+
+template<bool isBack>
+struct Feedback
+{
+    enum : uint16_t
+    {
+        SpeedDcLink = isBack ? BackSpeedDcLink : FrontSpeedDcLink,
+        IqId = isBack ? BackIqId : FrontIqId,
+    };
+};
+
+struct FeedbackLane
+{
+    bool isRight;
+    int16_t MotorFeedback::*member;
+};
+
+struct CommandLane
+{
+    bool isBack;
+    bool isRight;
+    int16_t MotorState::*member;
+};
+
+constexpr std::array<FeedbackLane, 4> speedDcLinkLayout{{
+        {false, &MotorFeedback::speed},
+        {true, &MotorFeedback::speed},
+        {false, &MotorFeedback::dcLink},
+        {true, &MotorFeedback::dcLink},
+}};
+
+constexpr std::array<FeedbackLane, 4> iqIdLayout{{
+        {false, &MotorFeedback::iq},
+        {true, &MotorFeedback::iq},
+        {false, &MotorFeedback::id},
+        {true, &MotorFeedback::id},
+}};
+
+// one frame for all four motors, each board picks its own lanes
+constexpr std::array<CommandLane, 4> inpTgtLayout{{
+        {false, false, &MotorState::pwm},
+        {false, true, &MotorState::pwm},
+        {true, false, &MotorState::pwm},
+        {true, true, &MotorState::pwm},
+}};
+
+static_assert(speedDcLinkLayout.size() * sizeof(int16_t) <= 8);
+static_assert(iqIdLayout.size() * sizeof(int16_t) <= 8);
+static_assert(inpTgtLayout.size() * sizeof(int16_t) <= 8);
+
+} // namespace can::packed
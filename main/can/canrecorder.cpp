@@ -0,0 +1,276 @@
+#include "canrecorder.h"
+
+constexpr auto TAG = "CANREC";
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// system includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+// esp-idf includes
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_spiffs.h>
+
+// local includes
+#include "utils/crashloop.h"
+
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+
+namespace can::recorder {
+
+namespace {
+
+    struct Record
+    {
+        int64_t timestamp;
+        uint32_t identifier;
+        uint8_t flags; // bit 7: tx, bits 0-3: dlc
+        uint8_t data[8];
+    };
+
+    constexpr uint8_t FLAG_TX = 0x80;
+    constexpr uint8_t RAW_IDENTIFIER = 0xFF;
+    constexpr size_t LOG_FILES = 4;
+    constexpr uint32_t RING_MAGIC = 0xB0BBCA11;
+
+    // not cleared by panic and watchdog resets, so the boot after a crash can still write the frames leading up to
+    // it. Holds garbage after power on, the contents only count while the magic matches.
+    struct Ring
+    {
+        uint32_t magic;
+        size_t next; // only written by record(), always accessed through std::atomic_ref
+        std::array<Record, CONFIG_BOBBYCAR_CAN_RECORDER_FRAMES> records;
+    };
+
+    __NOINIT_ATTR Ring ring;
+
+    std::atomic_ref<size_t> next()
+    {
+        return std::atomic_ref<size_t>{ring.next};
+    }
+
+    std::atomic<bool> frozen{false};
+    std::atomic<bool> flushRequested{false};
+    // the ring still holds the frames of the boot that crashed, they are dropped once written
+    std::atomic<bool> crashLogPending{false};
+
+    bool mounted{false};
+
+    std::atomic<uint32_t> _flushedLogs;
+
+    class Writer
+    {
+    public:
+        explicit Writer(FILE *file) : m_file{file}
+        {
+        }
+
+        ~Writer()
+        {
+            flush();
+        }
+
+        void write(const void *data, const size_t size)
+        {
+            if (m_used + size > m_buffer.size()) flush();
+            std::memcpy(m_buffer.data() + m_used, data, size);
+            m_used += size;
+        }
+
+        template<typename T>
+        void write(const T value)
+        {
+            write(&value, sizeof(value));
+        }
+
+        void writeVarint(uint64_t value)
+        {
+            do
+            {
+                uint8_t byte = value & 0x7F;
+                value >>= 7;
+                if (value) byte |= 0x80;
+                write(byte);
+            } while (value);
+        }
+
+        void flush()
+        {
+            if (m_used) std::fwrite(m_buffer.data(), 1, m_used, m_file);
+            m_used = 0;
+        }
+
+    private:
+        FILE *m_file;
+        std::array<uint8_t, 256> m_buffer;
+        size_t m_used{0};
+    };
+
+    bool mount()
+    {
+        if (mounted) return true;
+
+        const esp_vfs_spiffs_conf_t conf{
+                .base_path = "/spiffs",
+                .partition_label = "spiffs",
+                .max_files = 2,
+                .format_if_mount_failed = true,
+        };
+
+        if (const auto result = esp_vfs_spiffs_register(&conf); result != ESP_OK)
+        {
+            ESP_LOGE(TAG, "esp_vfs_spiffs_register() failed with %s", esp_err_to_name(result));
+            return false;
+        }
+
+        mounted = true;
+        return true;
+    }
+
+    void unfreeze()
+    {
+        // timestamps restart with every boot, frames of this boot must not be appended to the ones of the crash
+        if (crashLogPending.exchange(false)) next().store(0);
+        frozen = false;
+    }
+
+    void flush()
+    {
+        if (!mount())
+        {
+            unfreeze();
+            return;
+        }
+
+        // record() might still be writing the slot at end, which holds the oldest frame once the ring is full
+        frozen = true;
+        const size_t end = next().load();
+        const size_t begin = end >= ring.records.size() ? end - ring.records.size() + 1 : 0;
+
+        std::array<uint32_t, RAW_IDENTIFIER> dictionary;
+        size_t dictionarySize{0};
+
+        const auto lookup = [&](const uint32_t identifier) -> uint8_t {
+            for (size_t i = 0; i < dictionarySize; ++i)
+                if (dictionary[i] == identifier) return i;
+            return RAW_IDENTIFIER;
+        };
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto identifier = ring.records[i % ring.records.size()].identifier;
+            if (lookup(identifier) == RAW_IDENTIFIER && dictionarySize < dictionary.size())
+                dictionary[dictionarySize++] = identifier;
+        }
+
+        char path[32];
+        std::snprintf(path, sizeof(path), "/spiffs/canlog%u.bin", unsigned(_flushedLogs.load() % LOG_FILES));
+
+        FILE *file = std::fopen(path, "wb");
+        if (!file)
+        {
+            ESP_LOGE(TAG, "could not open %s", path);
+            unfreeze();
+            return;
+        }
+
+        {
+            Writer writer{file};
+
+            const int64_t start = end > begin ? ring.records[begin % ring.records.size()].timestamp : 0;
+
+            writer.write("BCL1", 4);
+            writer.write(uint16_t(dictionarySize));
+            writer.write(uint16_t{0});
+            writer.write(uint32_t(end - begin));
+            writer.write(start);
+            writer.write(dictionary.data(), dictionarySize * sizeof(uint32_t));
+
+            int64_t last = start;
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto &record = ring.records[i % ring.records.size()];
+
+                writer.writeVarint(record.timestamp - last);
+                last = record.timestamp;
+
+                const auto index = lookup(record.identifier);
+                writer.write(index);
+                if (index == RAW_IDENTIFIER) writer.write(record.identifier);
+
+                writer.write(record.flags);
+                writer.write(record.data, record.flags & 0x0F);
+            }
+        }
+
+        std::fclose(file);
+
+        unfreeze();
+
+        ++_flushedLogs;
+
+        ESP_LOGI(TAG, "wrote %u frames to %s", unsigned(end - begin), path);
+    }
+
+} // namespace
+
+const std::atomic<uint32_t> &flushedLogs{_flushedLogs};
+
+void record(const Direction direction, const twai_message_t &message, const int64_t timestamp)
+{
+    if (frozen.load(std::memory_order_relaxed)) return;
+
+    const auto index = next().load(std::memory_order_relaxed);
+    auto &slot = ring.records[index % ring.records.size()];
+
+    const uint8_t length = std::min<uint8_t>(message.data_length_code, sizeof(slot.data));
+
+    slot.timestamp = timestamp;
+    slot.identifier = message.identifier;
+    slot.flags = length | (direction == Direction::Tx ? FLAG_TX : 0);
+    std::memcpy(slot.data, message.data, length);
+
+    next().store(index + 1, std::memory_order_release);
+}
+
+void begin()
+{
+    if (ring.magic == RING_MAGIC && init::crashCount() && next().load())
+    {
+        const auto kept = std::min(next().load(), ring.records.size());
+        ESP_LOGW(TAG, "keeping %u frames from before the crash", unsigned(kept));
+
+        // nothing overwrites them until the first update() wrote them out
+        crashLogPending = true;
+        frozen = true;
+        flushRequested = true;
+        return;
+    }
+
+    ring.magic = RING_MAGIC;
+    next().store(0);
+}
+
+void requestFlush()
+{
+    flushRequested = true;
+}
+
+void init()
+{
+}
+
+void update()
+{
+    if (flushRequested.exchange(false)) flush();
+}
+
+} // namespace can::recorder
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+// system includes
+#include <atomic>
+#include <cstdint>
+
+// esp-idf includes
+#include <driver/twai.h>
+
+// CAN flight recorder: keeps the last CONFIG_BOBBYCAR_CAN_RECORDER_FRAMES RX/TX frames in RAM and writes them to
+// the spiffs partition on request. The RAM survives panic and watchdog resets, so a crash gets logged by the next
+// boot.
+//
+// Log file layout (little endian):
+//   char[4]  magic "BCL1"
+//   uint16   dictionary size D
+//   uint16   reserved
+//   uint32   record count
+//   int64    timestamp of the first record (us since boot)
+//   uint32   identifiers[D]
+//   records:
+//     varint   delta to the previous record (us, LEB128)
+//     uint8    dictionary index, 0xFF is followed by the raw uint32 identifier
+//     uint8    bit 7: sent by us, bits 0-3: data length
+//     uint8    data[data length]
+namespace can::recorder {
+
+enum class Direction : uint8_t
+{
+    Rx,
+    Tx
+};
+
+// has to run before the CAN task starts, after init::checkCrashLoop(). If this boot follows a crash, the frames
+// recorded before it are kept and written by the first update().
+void begin();
+
+// not reentrant: only call from the realtime scheduler. The CAN task records RX frames and the drive task TX frames,
+// both run one after the other on sched_rt and never concurrently.
+void record(Direction direction, const twai_message_t &message, int64_t timestamp);
+
+// the next update() writes the current ring contents to a new log file
+void requestFlush();
+
+// scheduler callbacks
+void init();
+void update();
+
+// log files written since boot
+extern const std::atomic<uint32_t> &flushedLogs;
+
+} // namespace can::recorder
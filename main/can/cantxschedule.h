@@ -0,0 +1,197 @@
+#pragma once
+
+// system includes
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// 3rdparty lib includes
+#include <bobbycar-can.h>
+#include <espchrono.h>
+
+// local includes
+#include "canboards.h"
+#include "config/configsnapshot.h"
+#include "driving_modes/controllers.h"
+#include "utils/arrayutils.h"
+
+namespace can::txschedule {
+
+using namespace std::chrono_literals;
+
+enum class Target : uint8_t
+{
+    Board,
+    Boardcomputer
+};
+
+// controller is nullptr for Target::Boardcomputer, the returned bits are sent little endian
+using Reader = uint32_t (*)(const Controller *controller);
+
+struct ParameterClass
+{
+    uint8_t priority; // lower is more important
+    espchrono::millis_clock::duration maxAge;
+};
+
+namespace classes {
+    constexpr ParameterClass Safety{0, 100ms};
+    constexpr ParameterClass Cruise{1, 100ms};
+    constexpr ParameterClass ControlMode{2, 200ms};
+    constexpr ParameterClass Limits{3, 250ms};
+    constexpr ParameterClass Peripherals{4, 500ms};
+} // namespace classes
+
+struct Slot
+{
+    uint32_t identifier;
+    Target target;
+    uint8_t board; // motor board index for Target::Board
+    uint8_t size;
+    ParameterClass parameterClass;
+    Reader read;
+};
+
+namespace detail {
+    using bobbycar::protocol::serial::BuzzerState;
+    using bobbycar::protocol::serial::Command;
+    using bobbycar::protocol::serial::MotorState;
+
+    template<typename T>
+    uint32_t toBits(const T value)
+    {
+        static_assert(sizeof(T) <= sizeof(uint32_t));
+        uint32_t bits{};
+        std::memcpy(&bits, &value, sizeof(value));
+        return bits;
+    }
+
+    template<bool isRight, auto Member>
+    uint32_t readMotor(const Controller *controller)
+    {
+        return toBits((isRight ? controller->command.right : controller->command.left).*Member);
+    }
+
+    template<auto Member>
+    uint32_t readBuzzer(const Controller *controller)
+    {
+        return toBits(controller->command.buzzer.*Member);
+    }
+
+    template<auto Member>
+    uint32_t readCommand(const Controller *controller)
+    {
+        return toBits(controller->command.*Member);
+    }
+
+    inline uint32_t readButtonLeds(const Controller *)
+    {
+        using namespace bobbycar::protocol::can;
+
+        std::underlying_type_t<Boardcomputer::Button> buttonLeds{};
+        switch (config::snapshot.read([](const config::Snapshot &s) { return s.profileIndex; }))
+        {
+            case 0:
+                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile0);
+                break;
+            case 1:
+                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile1);
+                break;
+            case 2:
+                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile2);
+                break;
+            case 3:
+                buttonLeds |= std::to_underlying(Boardcomputer::Button::Profile3);
+                break;
+            default:
+                break;
+        }
+        return toBits(buttonLeds);
+    }
+
+    template<uint8_t board, bool isRight, auto Member>
+    constexpr Slot motorSlot(const uint32_t identifier, const ParameterClass parameterClass)
+    {
+        return {boards::identifier(board, identifier), Target::Board, board, sizeof(MotorState{}.*Member),
+                parameterClass, readMotor<isRight, Member>};
+    }
+
+    template<uint8_t board, bool isRight>
+    constexpr std::array<Slot, 10> motorSlots()
+    {
+        using Ids = typename boards::MotorController<board, isRight>::Command;
+
+        return {{
+                motorSlot<board, isRight, &MotorState::enable>(Ids::Enable, classes::Safety),
+                motorSlot<board, isRight, &MotorState::ctrlTyp>(Ids::CtrlTyp, classes::ControlMode),
+                motorSlot<board, isRight, &MotorState::ctrlMod>(Ids::CtrlMod, classes::ControlMode),
+                motorSlot<board, isRight, &MotorState::iMotMax>(Ids::IMotMax, classes::Limits),
+                motorSlot<board, isRight, &MotorState::iDcMax>(Ids::IDcMax, classes::Limits),
+                motorSlot<board, isRight, &MotorState::nMotMax>(Ids::NMotMax, classes::Limits),
+                motorSlot<board, isRight, &MotorState::fieldWeakMax>(Ids::FieldWeakMax, classes::Limits),
+                motorSlot<board, isRight, &MotorState::phaseAdvMax>(Ids::PhaseAdvMax, classes::Limits),
+                motorSlot<board, isRight, &MotorState::nCruiseMotTgt>(Ids::CruiseMotTgt, classes::Cruise),
+                motorSlot<board, isRight, &MotorState::cruiseCtrlEna>(Ids::CruiseCtrlEna, classes::Cruise),
+        }};
+    }
+
+    // buzzer, led and poweroff exist once per board and use the left motor identifiers
+    template<uint8_t board>
+    constexpr std::array<Slot, 4> boardSlots()
+    {
+        using Ids = typename boards::MotorController<board, false>::Command;
+
+        const auto slot = [](const uint32_t identifier, const uint8_t size, const ParameterClass parameterClass,
+                             const Reader read) -> Slot {
+            return {boards::identifier(board, identifier), Target::Board, board, size, parameterClass, read};
+        };
+
+        return {{
+                slot(Ids::BuzzerFreq, sizeof(BuzzerState::freq), classes::Peripherals, readBuzzer<&BuzzerState::freq>),
+                slot(Ids::BuzzerPattern, sizeof(BuzzerState::pattern), classes::Peripherals,
+                     readBuzzer<&BuzzerState::pattern>),
+                slot(Ids::Led, sizeof(Command::led), classes::Peripherals, readCommand<&Command::led>),
+                slot(Ids::Poweroff, sizeof(Command::poweroff), classes::Safety, readCommand<&Command::poweroff>),
+        }};
+    }
+
+    template<uint8_t... board>
+    constexpr auto boardSlots(std::integer_sequence<uint8_t, board...>)
+    {
+        return arrayutils::concat(motorSlots<board, false>()..., motorSlots<board, true>()..., boardSlots<board>()...);
+    }
+
+    template<uint8_t... board>
+    constexpr auto inpTgtIdentifiers(std::integer_sequence<uint8_t, board...>)
+    {
+        using std::array;
+        return array<array<uint32_t, 2>, sizeof...(board)>{{
+                {boards::identifier(board, boards::MotorController<board, false>::Command::InpTgt),
+                 boards::identifier(board, boards::MotorController<board, true>::Command::InpTgt)}...,
+        }};
+    }
+
+    constexpr std::array<Slot, 1> boardcomputerSlots()
+    {
+        using namespace bobbycar::protocol::can;
+
+        return {{
+                {Boardcomputer::Feedback::ButtonLeds, Target::Boardcomputer, 0,
+                 sizeof(std::underlying_type_t<Boardcomputer::Button>), classes::Peripherals, readButtonLeds},
+        }};
+    }
+} // namespace detail
+
+// every command parameter besides InpTgt, which is sent on every tick
+constexpr auto slots = arrayutils::concat(detail::boardSlots(boards::indices), detail::boardcomputerSlots());
+
+// left and right InpTgt identifier of every board
+constexpr auto inpTgtIdentifiers = detail::inpTgtIdentifiers(boards::indices);
+
+static_assert(slots.size() <= 0xFF, "slot index has to fit into uint8_t");
+
+} // namespace can::txschedule
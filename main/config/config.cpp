@@ -3,6 +3,9 @@
 // 3rdparty lib includes
 #include <configmanager_priv.h>
 
+// local includes
+#include "configsnapshot.h"
+
 namespace config {
 ConfigManager<ConfigContainer> configs;
 
@@ -17,6 +20,8 @@ void switchProfile(const uint8_t index)
     }
 
     selectedProfile = &configs.profiles[index];
+
+    rebuildSnapshot();
 }
 
 } // namespace config
@@ -4,13 +4,16 @@
 #include "sdkconfig.h"
 
 // system includes
+#include <algorithm>
 #include <array>
+#include <cstddef>
 
 // 3rdparty lib includes
 #include <configconstraints_base.h>
 #include <configmanager.h>
 
 // local includes
+#include "configsnapshot.h"
 #include "profile.h"
 
 #if CONFIG_BOBBYCAR_DEFAULT_PROFILE >= CONFIG_BOBBYCAR_PROFILE_NUM
@@ -34,6 +37,11 @@ namespace helpers {
         return {};                                                                                                     \
     }
 
+    // nvs keys are limited to 15 characters
+    constexpr size_t NVS_KEY_MAX_LENGTH = 15;
+
+    static_assert(CONFIG_BOBBYCAR_PROFILE_NUM <= 10, "profile keys only have room for a single digit index");
+
     template<typename T>
     class ConfigWrapperChangeableKeyAndIndex : public ConfigWrapper<T>
     {
@@ -45,18 +53,23 @@ namespace helpers {
         using value_t = typename Base::value_t;
         using ConstraintCallback = typename Base::ConstraintCallback;
 
-        ConfigWrapperChangeableKeyAndIndex(const size_t idx, const char *nvsKey) : m_idx{idx}, m_nvsKey{nvsKey}
+        // the key is stored once with the index appended, nvsName() is called on every load and save
+        template<size_t N>
+        ConfigWrapperChangeableKeyAndIndex(const size_t idx, const char (&nvsKey)[N])
         {
+            static_assert(N - 1 + 1 <= NVS_KEY_MAX_LENGTH, "nvs key too long, the index needs one more character");
+
+            std::copy_n(nvsKey, N - 1, m_nvsName.begin());
+            m_nvsName[N - 1] = char('0' + idx);
         }
 
         const char *nvsName() const override final
         {
-            return (m_nvsKey + std::to_string(m_idx)).c_str();
+            return m_nvsName.data();
         }
 
     private:
-        size_t m_idx;
-        const char *m_nvsKey;
+        std::array<char, NVS_KEY_MAX_LENGTH + 1> m_nvsName{};
     };
 
     template<typename T>
@@ -69,8 +82,10 @@ namespace helpers {
         using value_t = typename Base::value_t;
         using ConstraintCallback = typename Base::ConstraintCallback;
 
-        explicit ConfigWrapperChangeableKey(const char *nvsKey) : m_nvsKey{nvsKey}
+        template<size_t N>
+        explicit ConfigWrapperChangeableKey(const char (&nvsKey)[N]) : m_nvsKey{nvsKey}
         {
+            static_assert(N - 1 <= NVS_KEY_MAX_LENGTH, "nvs key too long");
         }
 
         constexpr const char *nvsName() const override final
@@ -91,37 +106,37 @@ namespace helpers {
                     .iMotMax{idx, "limits_iMotMax"},
                     .iDcMax{idx, "limits_iDcMax"},
                     .nMotMax{idx, "limits_nMotMax"},
-                    .fieldWeakMax{idx, "limits_fWeakMax"},
-                    .phaseAdvMax{idx, "limits_phaseAdvMax"},
+                    .fieldWeakMax{idx, "limits_fwMax"},
+                    .phaseAdvMax{idx, "limits_phAdv"},
             },
             controllerHardware{
-                    .enableFrontLeft{idx, "ctrlHw_enFrontLeft"},
-                    .enableFrontRight{idx, "ctrlHw_enFrontRight"},
-                    .enableBackLeft{idx, "ctrlHw_enBackLeft"},
-                    .enableBackRight{idx, "ctrlHw_enBackRight"},
-                    .invertFrontLeft{idx, "ctrlHw_invFrontLeft"},
-                    .invertFrontRight{idx, "ctrlHw_invFrontRight"},
-                    .invertBackLeft{idx, "ctrlHw_invBackLeft"},
-                    .invertBackRight{idx, "ctrlHw_invBackRight"},
+                    .enableFrontLeft{idx, "ctrlHw_enFL"},
+                    .enableFrontRight{idx, "ctrlHw_enFR"},
+                    .enableBackLeft{idx, "ctrlHw_enBL"},
+                    .enableBackRight{idx, "ctrlHw_enBR"},
+                    .invertFrontLeft{idx, "ctrlHw_invFL"},
+                    .invertFrontRight{idx, "ctrlHw_invFR"},
+                    .invertBackLeft{idx, "ctrlHw_invBL"},
+                    .invertBackRight{idx, "ctrlHw_invBR"},
             },
             defaultMode{
-                    .modelMode{idx, "defMode_modelMode"},
-                    .allowRemoteControl{idx, "defMode_allowRC"},
+                    .modelMode{idx, "defMode_mMode"},
+                    .allowRemoteControl{idx, "defMode_alwRC"},
                     .squareGas{idx, "defMode_sqGas"},
-                    .squareBrems{idx, "defMode_sqBrems"},
+                    .squareBrems{idx, "defMode_sqBrm"},
                     .enableSmoothingUp{idx, "defMode_enSmUp"},
-                    .enableSmoothingDown{idx, "defMode_enSmDown"},
-                    .enableFieldWeakSmoothingUp{idx, "defMode_enSmFUp"},
-                    .enableFieldWeakSmoothingDown{idx, "defMode_enSmFDown"},
-                    .smoothing{idx, "defMode_smoothing"},
-                    .frontPercentage{idx, "defMode_frontPercent"},
-                    .backPercentage{idx, "defMode_backPercent"},
-                    .add_schwelle{idx, "defMode_addSchwelle"},
-                    .gas1_wert{idx, "defMode_gas1_wert"},
-                    .gas2_wert{idx, "defMode_gas2_wert"},
-                    .brems1_wert{idx, "defMode_brems1_wert"},
-                    .brems2_wert{idx, "defMode_brems2_wert"},
-                    .fwSmoothLowerLimit{idx, "defMode_fwSmoothLowerLimit"},
+                    .enableSmoothingDown{idx, "defMode_enSmDn"},
+                    .enableFieldWeakSmoothingUp{idx, "defMode_enSFUp"},
+                    .enableFieldWeakSmoothingDown{idx, "defMode_enSFDn"},
+                    .smoothing{idx, "defMode_smooth"},
+                    .frontPercentage{idx, "defMode_front"},
+                    .backPercentage{idx, "defMode_back"},
+                    .add_schwelle{idx, "defMode_addSch"},
+                    .gas1_wert{idx, "defMode_gas1"},
+                    .gas2_wert{idx, "defMode_gas2"},
+                    .brems1_wert{idx, "defMode_brems1"},
+                    .brems2_wert{idx, "defMode_brems2"},
+                    .fwSmoothLowerLimit{idx, "defMode_fwSmLL"},
             },
             m_idx{idx}
         {
@@ -458,7 +473,10 @@ namespace helpers {
                 {
                     return true;
                 }
-                NO_CONSTRAINT
+                ConfigConstraintReturnType checkValue(value_t value) const override
+                {
+                    return MinValue<value_t, 1>(value);
+                }
                 value_t defaultValue() const override
                 {
                     return 20;
@@ -902,4 +920,24 @@ extern ConfigManager<ConfigContainer> configs;
 
 extern helpers::ProfileConfig* selectedProfile;
 
+// selects the profile and rebuilds the config snapshot
+void switchProfile(uint8_t index);
+
+// every config write has to go through here, the control loop only sees the config snapshot
+template<typename T>
+auto writeConfig(ConfigWrapper<T> &config, const typename ConfigWrapper<T>::value_t value)
+{
+    const auto result = configs.write_config(config, value);
+    if (result) rebuildSnapshot();
+    return result;
+}
+
+// resets every config that allows it and rebuilds the config snapshot
+inline auto resetConfigs()
+{
+    const auto result = configs.reset();
+    rebuildSnapshot();
+    return result;
+}
+
 } // namespace config
@@ -0,0 +1,86 @@
+#include "configsnapshot.h"
+
+// system includes
+#include <mutex>
+
+// local includes
+#include "config/config.h"
+
+namespace config {
+
+namespace {
+    SnapshotBuffer<Snapshot> _snapshot;
+
+    // SnapshotBuffer allows only one writer
+    std::mutex rebuildMutex;
+
+    Profile makeProfile(const helpers::ProfileConfig &config)
+    {
+        return {
+                .limits{
+                        .iMotMax = config.limits.iMotMax.value(),
+                        .iDcMax = config.limits.iDcMax.value(),
+                        .nMotMax = config.limits.nMotMax.value(),
+                        .fieldWeakMax = config.limits.fieldWeakMax.value(),
+                        .phaseAdvMax = config.limits.phaseAdvMax.value(),
+                },
+                .controllerHardware{
+                        .enableFrontLeft = config.controllerHardware.enableFrontLeft.value(),
+                        .enableFrontRight = config.controllerHardware.enableFrontRight.value(),
+                        .enableBackLeft = config.controllerHardware.enableBackLeft.value(),
+                        .enableBackRight = config.controllerHardware.enableBackRight.value(),
+                        .invertFrontLeft = config.controllerHardware.invertFrontLeft.value(),
+                        .invertFrontRight = config.controllerHardware.invertFrontRight.value(),
+                        .invertBackLeft = config.controllerHardware.invertBackLeft.value(),
+                        .invertBackRight = config.controllerHardware.invertBackRight.value(),
+                },
+                .defaultMode{
+                        .modelMode = config.defaultMode.modelMode.value(),
+                        .allowRemoteControl = config.defaultMode.allowRemoteControl.value(),
+                        .squareGas = config.defaultMode.squareGas.value(),
+                        .squareBrems = config.defaultMode.squareBrems.value(),
+                        .enableSmoothingUp = config.defaultMode.enableSmoothingUp.value(),
+                        .enableSmoothingDown = config.defaultMode.enableSmoothingDown.value(),
+                        .enableFieldWeakSmoothingUp = config.defaultMode.enableFieldWeakSmoothingUp.value(),
+                        .enableFieldWeakSmoothingDown = config.defaultMode.enableFieldWeakSmoothingDown.value(),
+                        .smoothing = config.defaultMode.smoothing.value(),
+                        .frontPercentage = config.defaultMode.frontPercentage.value(),
+                        .backPercentage = config.defaultMode.backPercentage.value(),
+                        .add_schwelle = config.defaultMode.add_schwelle.value(),
+                        .gas1_wert = config.defaultMode.gas1_wert.value(),
+                        .gas2_wert = config.defaultMode.gas2_wert.value(),
+                        .brems1_wert = config.defaultMode.brems1_wert.value(),
+                        .brems2_wert = config.defaultMode.brems2_wert.value(),
+                        .fwSmoothLowerLimit = config.defaultMode.fwSmoothLowerLimit.value(),
+                },
+        };
+    }
+} // namespace
+
+const SnapshotBuffer<Snapshot> &snapshot{_snapshot};
+
+void rebuildSnapshot()
+{
+    const auto &hardware = configs.controllerHardware;
+
+    std::lock_guard lock{rebuildMutex};
+
+    _snapshot.publish({
+            .profileIndex = uint8_t(selectedProfile - configs.profiles.data()),
+            .profile = makeProfile(*selectedProfile),
+            .controllerHardware{
+                    .wheelDiameter = hardware.wheelDiameter.value(),
+                    .numMagnetPoles = hardware.wheelBase.value(),
+                    .swapFrontBack = hardware.swapFrontBack.value(),
+                    .sendFrontCanCmd = hardware.sendFrontCanCmd.value(),
+                    .sendBackCanCmd = hardware.sendBackCanCmd.value(),
+                    .recvCanCmd = hardware.recvCanCmd.value(),
+                    .canTransmitTimeout = hardware.canTransmitTimeout.value(),
+                    .canReceiveTimeout = hardware.canReceiveTimeout.value(),
+                    .canUninstallOnReset = hardware.canUninstallOnReset.value(),
+                    .canBusResetOnError = hardware.canBusResetOnError.value(),
+            },
+    });
+}
+
+} // namespace config
@@ -0,0 +1,40 @@
+#pragma once
+
+// system includes
+#include <cstdint>
+
+// local includes
+#include "config/profile.h"
+#include "utils/snapshotbuffer.h"
+
+namespace config {
+
+// Every value the control loop needs, copied out of the ConfigWrappers so the hot path reads plain memory
+// instead of calling value() for each of them.
+struct Snapshot
+{
+    uint8_t profileIndex; // index of selectedProfile
+    Profile profile;
+
+    struct
+    {
+        int16_t wheelDiameter;
+        int16_t numMagnetPoles; // configs.controllerHardware.wheelBase
+        bool swapFrontBack;
+        bool sendFrontCanCmd;
+        bool sendBackCanCmd;
+        bool recvCanCmd;
+        int16_t canTransmitTimeout;
+        int16_t canReceiveTimeout;
+        bool canUninstallOnReset;
+        bool canBusResetOnError;
+    } controllerHardware;
+};
+
+extern const SnapshotBuffer<Snapshot> &snapshot;
+
+// builds a new snapshot from selectedProfile and the global configs and publishes it in one step. switchProfile(),
+// writeConfig() and resetConfigs() call it, so configs must not be written around them.
+void rebuildSnapshot();
+
+} // namespace config
@@ -6,7 +6,49 @@
 // local includes
 #include "can/unifiedmodelmode.h"
 
+// plain copy of one helpers::ProfileConfig, see config/configsnapshot.h
 class Profile
 {
 public:
+    struct
+    {
+        int16_t iMotMax;
+        int16_t iDcMax;
+        int16_t nMotMax;
+        int16_t fieldWeakMax;
+        int16_t phaseAdvMax;
+    } limits;
+
+    struct
+    {
+        bool enableFrontLeft;
+        bool enableFrontRight;
+        bool enableBackLeft;
+        bool enableBackRight;
+        bool invertFrontLeft;
+        bool invertFrontRight;
+        bool invertBackLeft;
+        bool invertBackRight;
+    } controllerHardware;
+
+    struct
+    {
+        UnifiedModelMode modelMode;
+        bool allowRemoteControl;
+        bool squareGas;
+        bool squareBrems;
+        bool enableSmoothingUp;
+        bool enableSmoothingDown;
+        bool enableFieldWeakSmoothingUp;
+        bool enableFieldWeakSmoothingDown;
+        int16_t smoothing;
+        int16_t frontPercentage;
+        int16_t backPercentage;
+        int16_t add_schwelle;
+        int16_t gas1_wert;
+        int16_t gas2_wert;
+        int16_t brems1_wert;
+        int16_t brems2_wert;
+        int16_t fwSmoothLowerLimit;
+    } defaultMode;
 };
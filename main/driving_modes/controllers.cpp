@@ -1,6 +1,10 @@
 #include "controllers.h"
 
+#ifdef CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_CAN
+Controller::Controller() = default;
+#endif
+
 Controllers controllers;
 
 driving_modes::ModeInterface *lastMode;
-driving_modes::ModeInterface *currentMode;
\ No newline at end of file
+driving_modes::ModeInterface *currentMode;
@@ -1,12 +1,18 @@
 #pragma once
 
+// system includes
+#include <array>
+#include <cstddef>
+
 // 3rdparty lib includes
 #include <bobbycar-serial.h>
 #include <espchrono.h>
 
 // local includes
 #include "config/config.h"
+#include "config/configsnapshot.h"
 #include "modeinterface.h"
+#include "utils/snapshotbuffer.h"
 
 #if defined(CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_CAN) && defined(CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_UART)
 #error "CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_CAN and CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_UART are mutually exclusive"
@@ -36,9 +42,16 @@ struct Controller
 
 #ifdef CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_CAN
     espchrono::millis_clock::time_point lastCanFeedback{};
+#ifdef CONFIG_BOBBYCAR_CAN_PACKED_FRAMES
+    // packed commands are only sent while the board keeps sending packed feedback
+    espchrono::millis_clock::time_point lastPackedFeedback{};
+#endif
 #endif
     bool feedbackValid{};
+    // working copy, only touched by the task that decodes feedback
     bobbycar::protocol::serial::Feedback feedback{};
+    // consistent copies of feedback for every other task
+    SnapshotBuffer<bobbycar::protocol::serial::Feedback> feedbackSnapshot{};
 
 
 #ifdef CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_UART
@@ -48,8 +61,10 @@ struct Controller
     float getCalibratedVoltage() const;
 };
 
-class Controllers : std::array<Controller, 2>
+class Controllers : std::array<Controller, CONFIG_BOBBYCAR_MOTOR_BOARD_COUNT>
 {
+    using Base = std::array<Controller, CONFIG_BOBBYCAR_MOTOR_BOARD_COUNT>;
+
 public:
     Controllers(const Controllers &) = delete;
     Controllers &operator=(const Controllers &) = delete;
@@ -60,20 +75,35 @@ public:
     Controller &unswapped_front{operator[](0)};
     Controller &unswapped_back{operator[](1)};
 
-    explicit Controllers() : std::array<Controller, 2>{}
+    explicit Controllers() : Base{}
     {}
 
-    Controller &correctedFront() const
+    using Base::size;
+
+    Controller &unswapped(const size_t board)
     {
-        using namespace config;
+        return operator[](board);
+    }
 
-        return configs.controllerHardware.swapFrontBack.value() ? unswapped_back : unswapped_front;
+    // swapFrontBack only exchanges the first two boards
+    Controller &corrected(const size_t board)
+    {
+        return operator[](board < 2 && swapFrontBack() ? board ^ 1 : board);
+    }
+
+    Controller &correctedFront() const
+    {
+        return swapFrontBack() ? unswapped_back : unswapped_front;
     }
     Controller &correctedBack() const
     {
-        using namespace config;
+        return swapFrontBack() ? unswapped_front : unswapped_back;
+    }
 
-        return configs.controllerHardware.swapFrontBack.value() ? unswapped_front : unswapped_back;
+private:
+    static bool swapFrontBack()
+    {
+        return config::snapshot.read([](const config::Snapshot &s) { return s.controllerHardware.swapFrontBack; });
     }
 };
 
@@ -0,0 +1,60 @@
+#include "drive.h"
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// local includes
+#include "can/can.h"
+#include "config/configsnapshot.h"
+#include "driving_modes/controllers.h"
+#include "driving_modes/original.h"
+#include "driving_modes/recovery.h"
+#include "driving_modes/tempomat.h"
+#include "driving_modes/traction.h"
+#include "utils/boottimeline.h"
+#include "utils/crashloop.h"
+
+namespace driving_modes {
+
+void initDrive()
+{
+    if (currentMode) return;
+
+    if (init::recovery)
+    {
+        currentMode = &recoveryMode;
+        return;
+    }
+
+#if defined(CONFIG_BOBBYCAR_STARTUP_DRIVING_MODE_TRACTION)
+    currentMode = &tractionMode;
+#elif defined(CONFIG_BOBBYCAR_STARTUP_DRIVING_MODE_TEMPOMAT)
+    currentMode = &tempomatMode;
+#else
+    currentMode = &originalMode;
+#endif
+}
+
+void updateDrive()
+{
+    if (currentMode != lastMode)
+    {
+        if (lastMode) lastMode->stop();
+        if (currentMode) currentMode->start();
+        lastMode = currentMode;
+    }
+
+    if (!currentMode) return;
+
+    // the pedal values every mode reads, refreshed right before the mode runs
+    const bool allowRemoteControl =
+            config::snapshot.read([](const config::Snapshot &s) { return s.profile.defaultMode.allowRemoteControl; });
+    can::inputs::update(allowRemoteControl);
+
+    currentMode->update();
+    boot::mark(boot::Phase::FirstControlTick);
+
+    can::sendCanCommands();
+}
+
+} // namespace driving_modes
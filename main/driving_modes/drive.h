@@ -0,0 +1,9 @@
+#pragma once
+
+namespace driving_modes {
+
+// runs currentMode at CONFIG_BOBBYCAR_DRIVE_UPDATE_INTERVAL_MS and hands the commands to the CAN bus
+void initDrive();
+void updateDrive();
+
+} // namespace driving_modes
@@ -0,0 +1,44 @@
+#include "motorlanes.h"
+
+namespace motorlanes {
+
+Feedback feedback{};
+SnapshotBuffer<Feedback> feedbackSnapshot{};
+
+void store(const size_t board, const bobbycar::protocol::serial::Feedback &boardFeedback)
+{
+    for (const bool isRight : {false, true})
+    {
+        const auto &motor = isRight ? boardFeedback.right : boardFeedback.left;
+        const auto i = index(board, isRight);
+
+        feedback.speed[i] = motor.speed;
+        feedback.dcLink[i] = motor.dcLink;
+        feedback.iq[i] = motor.iq;
+        feedback.id[i] = motor.id;
+    }
+}
+
+Wheels wheels(const Profile &profile)
+{
+    const auto &hardware = profile.controllerHardware;
+    const auto sign = [](const bool invert) { return invert ? -1.f : 1.f; };
+
+    Wheels result;
+    for (size_t board = 0; board < COUNT / 2; ++board)
+    {
+        const bool front = board == 0;
+        const auto left = index(board, false);
+        const auto right = index(board, true);
+
+        result.sign[left] = sign(front ? hardware.invertFrontLeft : hardware.invertBackLeft);
+        result.sign[right] = sign(front ? hardware.invertFrontRight : hardware.invertBackRight);
+        result.enable[left] = front ? hardware.enableFrontLeft : hardware.enableBackLeft;
+        result.enable[right] = front ? hardware.enableFrontRight : hardware.enableBackRight;
+        result.front[left] = front;
+        result.front[right] = front;
+    }
+    return result;
+}
+
+} // namespace motorlanes
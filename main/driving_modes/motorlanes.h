@@ -0,0 +1,66 @@
+#pragma once
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// system includes
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// 3rdparty lib includes
+#include <bobbycar-serial.h>
+
+// local includes
+#include "config/profile.h"
+#include "utils/snapshotbuffer.h"
+
+// Per-wheel values of all boards, one array per quantity instead of one struct per motor, so per-wheel math can be
+// written once as a loop over every wheel. Wheels are numbered by board index with swapFrontBack applied, left
+// before right.
+namespace motorlanes {
+
+constexpr size_t COUNT = CONFIG_BOBBYCAR_MOTOR_BOARD_COUNT * 2;
+
+constexpr size_t index(const size_t board, const bool isRight)
+{
+    return board * 2 + (isRight ? 1 : 0);
+}
+
+template<typename T>
+using Lane = std::array<T, COUNT>;
+
+struct Feedback
+{
+    Lane<int16_t> speed;
+    Lane<int16_t> dcLink;
+    Lane<int16_t> iq;
+    Lane<int16_t> id;
+    Lane<uint8_t> valid; // feedbackValid of the board, set when the lanes get published
+};
+
+struct Command
+{
+    Lane<int16_t> pwm;
+    Lane<uint8_t> enable;
+};
+
+// how every wheel is mounted, boards past the back one are mounted like it
+struct Wheels
+{
+    Lane<float> sign; // -1 for inverted motors
+    Lane<uint8_t> enable;
+    Lane<uint8_t> front;
+};
+
+// working copy, only touched by the task that decodes feedback
+extern Feedback feedback;
+// consistent copies of feedback for every other task
+extern SnapshotBuffer<Feedback> feedbackSnapshot;
+
+// copies every lane quantity of both motors of one board out of its feedback
+void store(size_t board, const bobbycar::protocol::serial::Feedback &boardFeedback);
+
+Wheels wheels(const Profile &profile);
+
+} // namespace motorlanes
@@ -1,15 +1,145 @@
 #include "original.h"
 
+// system includes
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// 3rdparty lib includes
+#include <bobbycar-common.h>
+#include <bobbycar-serial.h>
+
+// local includes
+#include "can/can.h"
+#include "can/unifiedmodelmode.h"
+#include "config/configsnapshot.h"
+#include "driving_modes/controllers.h"
+#include "driving_modes/motorlanes.h"
+#include "utils/latencytrace.h"
+
 namespace driving_modes {
 
 OriginalMode originalMode;
 
+namespace {
+    using bobbycar::protocol::serial::MotorState;
+
+    original::Params loadParams(const Profile &profile)
+    {
+        const auto &mode = profile.defaultMode;
+
+        return {
+                .squareGas = mode.squareGas,
+                .squareBrems = mode.squareBrems,
+                .enableSmoothingUp = mode.enableSmoothingUp,
+                .enableSmoothingDown = mode.enableSmoothingDown,
+                .enableFieldWeakSmoothingUp = mode.enableFieldWeakSmoothingUp,
+                .enableFieldWeakSmoothingDown = mode.enableFieldWeakSmoothingDown,
+                .smoothing = float(mode.smoothing),
+                .frontPercentage = float(mode.frontPercentage),
+                .backPercentage = float(mode.backPercentage),
+                .addSchwelle = float(mode.add_schwelle),
+                .gas1Wert = float(mode.gas1_wert),
+                .gas2Wert = float(mode.gas2_wert),
+                .brems1Wert = float(mode.brems1_wert),
+                .brems2Wert = float(mode.brems2_wert),
+                .fwSmoothLowerLimit = float(mode.fwSmoothLowerLimit),
+        };
+    }
+
+    int16_t toPwm(const float pwm)
+    {
+        constexpr float min = std::numeric_limits<int16_t>::min();
+        constexpr float max = std::numeric_limits<int16_t>::max();
+        return int16_t(std::clamp(pwm, min, max));
+    }
+
+    void applyMotor(MotorState &motor, const Profile &profile, const SplittedModelMode mode,
+                    const motorlanes::Command &lanes, const size_t wheel)
+    {
+        const auto &limits = profile.limits;
+
+        motor.enable = lanes.enable[wheel];
+        motor.ctrlTyp = mode.first;
+        motor.ctrlMod = mode.second;
+        motor.pwm = lanes.pwm[wheel];
+        motor.cruiseCtrlEna = false;
+        motor.nCruiseMotTgt = 0;
+        motor.iMotMax = limits.iMotMax;
+        motor.iDcMax = limits.iDcMax;
+        motor.nMotMax = limits.nMotMax;
+        motor.fieldWeakMax = limits.fieldWeakMax;
+        motor.phaseAdvMax = limits.phaseAdvMax;
+    }
+} // namespace
+
 void OriginalMode::start()
 {
     Base::start();
+
+    m_state = {};
+    m_lastUpdate = espchrono::millis_clock::now();
 }
 
 void OriginalMode::update()
 {
+    const auto gas = can::inputs::gas.load();
+    const auto brems = can::inputs::brems.load();
+
+    latency::mark(latency::Stage::ModeUpdate);
+
+    const auto now = espchrono::millis_clock::now();
+    const float dtMs = std::chrono::duration<float, std::milli>{now - m_lastUpdate}.count();
+    m_lastUpdate = now;
+
+    // one consistent copy per tick, a profile switch never shows up halfway through
+    config::Snapshot snapshot;
+    config::snapshot.read(snapshot);
+
+    const auto &profile = snapshot.profile;
+
+    // no pedal values means no torque, start from standstill once they are back
+    SplittedModelMode mode{bobbycar::protocol::ControlType::FieldOrientedControl,
+                           bobbycar::protocol::ControlMode::OpenMode};
+    original::Output output{0.f, 0.f};
+
+    if (gas && brems)
+    {
+        mode = split(profile.defaultMode.modelMode);
+        output = original::step(loadParams(profile), m_state, *gas, *brems, dtMs);
+    }
+    else
+    {
+        m_state = {};
+    }
+
+    // one pass over every wheel, then scattered into the board commands
+    const auto wheels = motorlanes::wheels(profile);
+
+    motorlanes::Lane<float> pwm;
+    for (size_t i = 0; i < motorlanes::COUNT; ++i)
+        pwm[i] = wheels.sign[i] * (wheels.front[i] ? output.front : output.back);
+
+    limitWheels(pwm, dtMs);
+
+    motorlanes::Command lanes;
+    for (size_t i = 0; i < motorlanes::COUNT; ++i)
+    {
+        lanes.pwm[i] = toPwm(pwm[i]);
+        lanes.enable[i] = wheels.enable[i];
+    }
+
+    const bool swap = snapshot.controllerHardware.swapFrontBack;
+    for (size_t board = 0; board < controllers.size(); ++board)
+    {
+        auto &command = controllers.unswapped(board < 2 && swap ? board ^ 1 : board).command;
+
+        applyMotor(command.left, profile, mode, lanes, motorlanes::index(board, false));
+        applyMotor(command.right, profile, mode, lanes, motorlanes::index(board, true));
+    }
+
+    latency::mark(latency::Stage::CommandBuild);
 }
 } // namespace driving_modes
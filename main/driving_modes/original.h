@@ -1,11 +1,16 @@
 #pragma once
 
+// 3rdparty lib includes
+#include <espchrono.h>
+
 // local includes
 #include "driving_modes/modeinterface.h"
+#include "driving_modes/motorlanes.h"
+#include "driving_modes/originalkernel.h"
 
 namespace driving_modes {
 
-class OriginalMode final : public ModeInterface
+class OriginalMode : public ModeInterface
 {
     using Base = ModeInterface;
 
@@ -18,6 +23,15 @@ public:
     {
         return "Original";
     }
+
+protected:
+    // last chance to change the pwm of every wheel before it is sent, values are already signed per wheel
+    virtual void limitWheels(motorlanes::Lane<float> &pwm, float dtMs)
+    {}
+
+private:
+    original::State m_state{};
+    espchrono::millis_clock::time_point m_lastUpdate{};
 };
 
 extern OriginalMode originalMode;
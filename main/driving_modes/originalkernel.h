@@ -0,0 +1,79 @@
+#pragma once
+
+// system includes
+#include <algorithm>
+#include <limits>
+
+// Pedal to pwm kernel of OriginalMode. Free of config and hardware access, so it can be run with fixed inputs.
+namespace driving_modes::original {
+
+// gas and brems range from 0 to 1000, pwm values above 1000 are field weakening
+struct Params
+{
+    bool squareGas;
+    bool squareBrems;
+    bool enableSmoothingUp;
+    bool enableSmoothingDown;
+    bool enableFieldWeakSmoothingUp;
+    bool enableFieldWeakSmoothingDown;
+    float smoothing; // pwm change per 100ms, <= 0 disables the rate limit
+    float frontPercentage;
+    float backPercentage;
+    float addSchwelle;
+    float gas1Wert;
+    float gas2Wert;
+    float brems1Wert;
+    float brems2Wert;
+    float fwSmoothLowerLimit;
+};
+
+struct State
+{
+    float lastPwm{};
+};
+
+struct Output
+{
+    float front;
+    float back;
+};
+
+inline float shape(const float value, const bool square)
+{
+    return square ? value * value / 1000.f : value;
+}
+
+inline Output step(const Params &params, State &state, const float gas, const float brems, const float dtMs)
+{
+    constexpr float unlimited = std::numeric_limits<float>::infinity();
+
+    const float shapedGas = shape(gas, params.squareGas);
+    const float shapedBrems = shape(brems, params.squareBrems);
+
+    const float last = state.lastPwm;
+    // no rate at all means no rate limit, a negative one must not turn the smoothing bounds around either
+    const float maxStep = params.smoothing > 0.f ? params.smoothing * dtMs / 100.f : unlimited;
+
+    // above add_schwelle: gas1/brems1 curve, smoothing only in the field weakening range and rising pwm jumps to
+    // 1000 right away
+    const bool add = shapedGas >= params.addSchwelle;
+
+    const float addPwm = shapedGas / 1000.f * params.gas1Wert - shapedBrems / 1000.f * params.brems1Wert;
+    const float addLower = params.enableSmoothingDown && last > 1000.f ? last - maxStep : -unlimited;
+    const float addUpper = params.enableSmoothingUp ? std::max(last + maxStep, 1000.f) : unlimited;
+
+    // below add_schwelle: gas2/brems2 curve, smoothing only while braking out of field weakening
+    const bool fwActive = last > params.fwSmoothLowerLimit && shapedBrems > 0.f;
+
+    const float basePwm = shapedGas / 1000.f * params.gas2Wert - shapedBrems / 1000.f * params.brems2Wert;
+    const float baseLower = fwActive && params.enableFieldWeakSmoothingDown ? last - maxStep : -unlimited;
+    const float baseUpper = fwActive && params.enableFieldWeakSmoothingUp ? last + maxStep : unlimited;
+
+    const float pwm = add ? std::clamp(addPwm, addLower, addUpper) : std::clamp(basePwm, baseLower, baseUpper);
+
+    state.lastPwm = pwm;
+
+    return {pwm * params.frontPercentage / 100.f, pwm * params.backPercentage / 100.f};
+}
+
+} // namespace driving_modes::original
@@ -0,0 +1,32 @@
+#include "recovery.h"
+
+// system includes
+#include <cstddef>
+
+// 3rdparty lib includes
+#include <bobbycar-common.h>
+
+// local includes
+#include "driving_modes/controllers.h"
+
+namespace driving_modes {
+
+RecoveryMode recoveryMode;
+
+void RecoveryMode::update()
+{
+    for (size_t board = 0; board < controllers.size(); ++board)
+    {
+        auto &command = controllers.unswapped(board).command;
+        for (auto *motor : {&command.left, &command.right})
+        {
+            motor->enable = false;
+            motor->ctrlTyp = bobbycar::protocol::ControlType::FieldOrientedControl;
+            motor->ctrlMod = bobbycar::protocol::ControlMode::OpenMode;
+            motor->pwm = 0;
+            motor->cruiseCtrlEna = false;
+            motor->nCruiseMotTgt = 0;
+        }
+    }
+}
+} // namespace driving_modes
@@ -0,0 +1,21 @@
+#pragma once
+
+// local includes
+#include "driving_modes/modeinterface.h"
+
+namespace driving_modes {
+
+// Only mode of a recovery boot, keeps every motor disabled with a zero command and ignores the pedals
+class RecoveryMode final : public ModeInterface
+{
+public:
+    void update() override;
+
+    const std::string displayName() const override
+    {
+        return "Recovery";
+    }
+};
+
+extern RecoveryMode recoveryMode;
+} // namespace driving_modes
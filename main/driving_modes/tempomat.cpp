@@ -0,0 +1,162 @@
+#include "tempomat.h"
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+// system includes
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// 3rdparty lib includes
+#include <bobbycar-common.h>
+#include <bobbycar-serial.h>
+
+// local includes
+#include "can/can.h"
+#include "can/unifiedmodelmode.h"
+#include "config/configsnapshot.h"
+#include "driving_modes/controllers.h"
+#include "driving_modes/motorlanes.h"
+
+namespace driving_modes {
+
+TempomatMode tempomatMode;
+
+namespace {
+    using bobbycar::protocol::serial::MotorState;
+
+    constexpr float ADJUST_RPM_PER_MS = CONFIG_BOBBYCAR_TEMPOMAT_ADJUST_RPM_PER_S / 1000.f;
+
+    // a pedal above this counts as pressed for the stop gesture
+    constexpr float PEDAL_PRESSED = 500.f;
+
+    // a brake press above this hands over to the OriginalMode brake path until the pedal is let go again
+    constexpr float BRAKE_DISENGAGE = CONFIG_BOBBYCAR_TEMPOMAT_BRAKE_DISENGAGE;
+    constexpr float BRAKE_RELEASED = 50.f;
+
+    // pwm stays 0, the motor controllers regulate towards nCruiseMotTgt on their own
+    void applyMotor(MotorState &motor, const Profile &profile, const SplittedModelMode mode, const bool cruise,
+                    const int16_t target, const bool enable)
+    {
+        const auto &limits = profile.limits;
+
+        motor.enable = enable;
+        motor.ctrlTyp = mode.first;
+        motor.ctrlMod = mode.second;
+        motor.pwm = 0;
+        motor.cruiseCtrlEna = cruise;
+        motor.nCruiseMotTgt = cruise ? target : 0;
+        motor.iMotMax = limits.iMotMax;
+        motor.iDcMax = limits.iDcMax;
+        motor.nMotMax = limits.nMotMax;
+        motor.fieldWeakMax = limits.fieldWeakMax;
+        motor.phaseAdvMax = limits.phaseAdvMax;
+    }
+} // namespace
+
+void TempomatMode::start()
+{
+    Base::start();
+
+    m_engaged = false;
+    m_braking = false;
+    m_lastUpdate = espchrono::millis_clock::now();
+}
+
+void TempomatMode::update()
+{
+    const auto gas = can::inputs::gas.load();
+    const auto brems = can::inputs::brems.load();
+
+    const auto now = espchrono::millis_clock::now();
+    const float dtMs = std::chrono::duration<float, std::milli>{now - m_lastUpdate}.count();
+    m_lastUpdate = now;
+
+    const bool braking = gas && brems && *brems > (m_braking ? BRAKE_RELEASED : BRAKE_DISENGAGE) &&
+                         *gas <= PEDAL_PRESSED;
+    if (braking)
+    {
+        if (!m_braking) m_brakeMode.start();
+        m_braking = true;
+        m_engaged = false;
+
+        // clears the cruise fields, the setpoint is taken over from the speed left once the brake is let go
+        m_brakeMode.update();
+        return;
+    }
+    m_braking = false;
+
+    config::Snapshot snapshot;
+    config::snapshot.read(snapshot);
+
+    const auto &profile = snapshot.profile;
+
+    // no pedal values means no torque, the setpoint is taken over from the current speed once they are back
+    SplittedModelMode mode{bobbycar::protocol::ControlType::FieldOrientedControl,
+                           bobbycar::protocol::ControlMode::OpenMode};
+
+    if (gas && brems)
+    {
+        if (!m_engaged) m_setpoint = can::outputs::averageSpeed.load();
+        m_engaged = true;
+
+        if (*gas > PEDAL_PRESSED && *brems > PEDAL_PRESSED)
+        {
+            m_setpoint = 0.f;
+        }
+        else
+        {
+            // gas speeds up and brems slows down in the direction of travel, never through standstill
+            const float direction = m_setpoint < 0.f ? -1.f : 1.f;
+            const float speed = std::abs(m_setpoint) + (*gas - *brems) / 1000.f * ADJUST_RPM_PER_MS * dtMs;
+            m_setpoint = direction * std::max(speed, 0.f);
+        }
+
+        const float maxRpm = profile.limits.nMotMax;
+        m_setpoint = std::clamp(m_setpoint, -maxRpm, maxRpm);
+
+        mode = split(UnifiedModelMode::FocSpeed);
+    }
+    else
+    {
+        m_engaged = false;
+    }
+
+    const auto wheels = motorlanes::wheels(profile);
+
+    // nCruiseMotTgt only changes while a pedal moves the setpoint, the tx schedule sends nothing else for it
+    motorlanes::Lane<int16_t> targets;
+    for (size_t i = 0; i < motorlanes::COUNT; ++i) targets[i] = int16_t(wheels.sign[i] * m_setpoint);
+
+    const bool swap = snapshot.controllerHardware.swapFrontBack;
+    for (size_t board = 0; board < controllers.size(); ++board)
+    {
+        auto &command = controllers.unswapped(board < 2 && swap ? board ^ 1 : board).command;
+
+        const auto left = motorlanes::index(board, false);
+        const auto right = motorlanes::index(board, true);
+
+        applyMotor(command.left, profile, mode, m_engaged, targets[left], wheels.enable[left]);
+        applyMotor(command.right, profile, mode, m_engaged, targets[right], wheels.enable[right]);
+    }
+}
+
+void TempomatMode::stop()
+{
+    Base::stop();
+
+    // the next mode may not touch the cruise fields, never leave the boards regulating on their own
+    for (size_t board = 0; board < controllers.size(); ++board)
+    {
+        auto &command = controllers.unswapped(board).command;
+        for (auto *motor : {&command.left, &command.right})
+        {
+            motor->cruiseCtrlEna = false;
+            motor->nCruiseMotTgt = 0;
+        }
+    }
+}
+} // namespace driving_modes
@@ -0,0 +1,40 @@
+#pragma once
+
+// 3rdparty lib includes
+#include <espchrono.h>
+
+// local includes
+#include "driving_modes/modeinterface.h"
+#include "driving_modes/original.h"
+
+namespace driving_modes {
+
+// Holds a speed setpoint with the FocSpeed loop of the motor controllers. Gas raises and brems lowers the setpoint
+// down to standstill, both pedals pressed at once bring it there right away. A brake press above
+// CONFIG_BOBBYCAR_TEMPOMAT_BRAKE_DISENGAGE lets go of the setpoint and brakes like OriginalMode.
+class TempomatMode final : public ModeInterface
+{
+    using Base = ModeInterface;
+
+public:
+    void start() override;
+
+    void update() override;
+
+    void stop() override;
+
+    const std::string displayName() const override
+    {
+        return "Tempomat";
+    }
+
+private:
+    float m_setpoint{}; // rpm, forward positive
+    bool m_engaged{};
+    bool m_braking{};
+    OriginalMode m_brakeMode;
+    espchrono::millis_clock::time_point m_lastUpdate{};
+};
+
+extern TempomatMode tempomatMode;
+} // namespace driving_modes
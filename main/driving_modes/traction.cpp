@@ -0,0 +1,26 @@
+#include "traction.h"
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+namespace driving_modes {
+
+TractionMode tractionMode;
+
+void TractionMode::start()
+{
+    Base::start();
+
+    m_params = traction::makeParams(CONFIG_BOBBYCAR_TRACTION_SLIP_PERCENT, CONFIG_BOBBYCAR_TRACTION_SLIP_MIN_RPM,
+                                    CONFIG_BOBBYCAR_TRACTION_CUT_RPM, CONFIG_BOBBYCAR_TRACTION_RECOVERY_MS);
+    traction::reset(m_traction);
+}
+
+void TractionMode::limitWheels(motorlanes::Lane<float> &pwm, const float dtMs)
+{
+    motorlanes::Feedback feedback;
+    motorlanes::feedbackSnapshot.read(feedback);
+
+    traction::step(m_params, m_traction, feedback.speed, feedback.valid, pwm, dtMs);
+}
+} // namespace driving_modes
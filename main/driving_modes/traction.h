@@ -0,0 +1,31 @@
+#pragma once
+
+// local includes
+#include "driving_modes/original.h"
+#include "driving_modes/tractionkernel.h"
+
+namespace driving_modes {
+
+// OriginalMode with the pwm of spinning wheels cut back
+class TractionMode final : public OriginalMode
+{
+    using Base = OriginalMode;
+
+public:
+    void start() override;
+
+    const std::string displayName() const override
+    {
+        return "Traction";
+    }
+
+protected:
+    void limitWheels(motorlanes::Lane<float> &pwm, float dtMs) override;
+
+private:
+    traction::Params m_params{};
+    traction::State<motorlanes::COUNT> m_traction{};
+};
+
+extern TractionMode tractionMode;
+} // namespace driving_modes
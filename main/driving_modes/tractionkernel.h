@@ -0,0 +1,85 @@
+#pragma once
+
+// system includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Slip limiter of TractionMode. Free of config and hardware access, so it can be run with recorded feedback. N is the
+// number of wheels, TractionMode runs it over motorlanes.
+namespace driving_modes::traction {
+
+// everything that would need a division is turned into a factor once, step() only multiplies
+struct Params
+{
+    float slipFactor;    // 1 + allowed slip ratio
+    float slipMinRpm;    // dead band on top of the allowed slip
+    float cutPerRpm;     // grip lost per rpm above the allowed slip
+    float recoveryPerMs; // grip regained per ms
+};
+
+// grip is the share of the requested drive pwm a wheel gets, 1 means untouched
+template<size_t N>
+struct State
+{
+    std::array<float, N> grip;
+};
+
+inline Params makeParams(const float slipPercent, const float slipMinRpm, const float cutRpm, const float recoveryMs)
+{
+    return {
+            .slipFactor = 1.f + slipPercent / 100.f,
+            .slipMinRpm = slipMinRpm,
+            .cutPerRpm = 1.f / cutRpm,
+            .recoveryPerMs = 1.f / recoveryMs,
+    };
+}
+
+template<size_t N>
+void reset(State<N> &state)
+{
+    state.grip.fill(1.f);
+}
+
+// Compares every wheel against the slowest valid one and scales pwm down on the ones spinning faster than allowed.
+// Only drive pwm gets cut, that is pwm pushing in the direction the wheel turns. Braking pwm always passes, while
+// braking the slowest wheel is the one locking up and cutting the others would only take away brake force.
+// Cutting happens in the same tick, recovering is rate limited so a wheel does not break loose again right away.
+// Without at least two valid wheels there is no reference and everything passes through. speed and pwm are both in
+// the motor's own direction, so the mounting of a wheel does not matter.
+template<size_t N>
+void step(const Params &params, State<N> &state, const std::array<int16_t, N> &speed,
+          const std::array<uint8_t, N> &valid, std::array<float, N> &pwm, const float dtMs)
+{
+    constexpr float unknown = std::numeric_limits<float>::max();
+
+    std::array<float, N> absSpeed;
+    float reference = unknown;
+    size_t validCount{};
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        absSpeed[i] = speed[i] < 0 ? -float(speed[i]) : float(speed[i]);
+        reference = std::min(reference, valid[i] ? absSpeed[i] : unknown);
+        validCount += valid[i];
+    }
+
+    const bool hasReference = validCount >= 2;
+    const float recovery = params.recoveryPerMs * dtMs;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        const bool driving = pwm[i] * float(speed[i]) > 0.f;
+
+        const float excess = absSpeed[i] - reference * params.slipFactor - params.slipMinRpm;
+        const float target = driving ? std::clamp(1.f - excess * params.cutPerRpm, 0.f, 1.f) : 1.f;
+        const float recovered = std::min(state.grip[i] + recovery, 1.f);
+
+        state.grip[i] = hasReference && valid[i] ? std::min(target, recovered) : 1.f;
+        pwm[i] *= driving ? state.grip[i] : 1.f;
+    }
+}
+
+} // namespace driving_modes::traction
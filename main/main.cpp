@@ -1,21 +1,33 @@
+// sdkconfig includes
+#include "sdkconfig.h"
+
 // esp-idf includes
 #include "config/config.h"
 
 #include <esp_log.h>
 #include <freertos/FreeRTOS.h>
 
-namespace init {
-
-RTC_NOINIT_ATTR bool recovery;
-
-} // namespace init
+// local includes
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+#include "can/canrecorder.h"
+#endif
+#include "tasks/taskmanager.h"
+#include "utils/boottimeline.h"
+#include "utils/crashloop.h"
 
 extern "C" [[noreturn]] void app_main()
 {
     using namespace config;
 
+    boot::mark(boot::Phase::AppMain);
+
     ESP_LOGI("main", "Hello, world!");
 
+    init::checkCrashLoop();
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+    can::recorder::begin();
+#endif
+
     // == Bobbycar Settings == //
     if (const auto result = configs.init("bobbycar"); result != ESP_OK)
     {
@@ -24,6 +36,7 @@ extern "C" [[noreturn]] void app_main()
     }
 
     ESP_LOGI("main", "config_init_settings() succeeded");
+    boot::mark(boot::Phase::ConfigInit);
 
     // == Selected Profile == //
     const auto selectedProfileIndex = configs.profileIndex.value();
@@ -35,10 +48,8 @@ extern "C" [[noreturn]] void app_main()
         abort();
     }
 
-    selectedProfile = &configs.profiles[selectedProfileIndex];
+    switchProfile(selectedProfileIndex);
+    boot::mark(boot::Phase::ProfileSelected);
 
-    while (true)
-    {
-        vTaskDelay(1000 / portTICK_PERIOD_MS);
-    }
+    sched_runTasks(init::recovery);
 }
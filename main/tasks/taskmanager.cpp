@@ -5,14 +5,33 @@
 
 constexpr auto TAG = "taskmanager";
 
+// system includes
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <optional>
+
 // esp-idf includes
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 // 3rdparty lib includes
 #include <espchrono.h>
 
 // local includes
 #include "can/can.h"
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+#include "can/canrecorder.h"
+#endif
+#include "driving_modes/drive.h"
+#include "utils/boottimeline.h"
+#include "utils/crashloop.h"
+#include "utils/latencytrace.h"
+#include "utils/snapshotbuffer.h"
 
 namespace {
 
@@ -28,12 +47,266 @@ namespace {
 using namespace espcpputils;
 using namespace std::chrono_literals;
 
+#ifdef CONFIG_BOBBYCAR_PRINT_TASK_STATS
+constexpr bool PRINT_TASK_STATS = true;
+#else
+constexpr bool PRINT_TASK_STATS = false;
+#endif
+
 BobbySchedulerTask tasksArray[]{
 #ifdef CONFIG_BOBBYCAR_COMMUNICATION_PROTOCOL_CAN
-        BobbySchedulerTask{"can", can::initCan, can::updateCan, CONFIG_BOBBYCAR_CAN_UPDATE_INTERVAL_MS * 1ms, false},
+        BobbySchedulerTask{"can", can::initCan, can::updateCan, CONFIG_BOBBYCAR_CAN_UPDATE_INTERVAL_MS * 1ms, true,
+                           false, false, nullptr, SchedulerClass::Realtime},
+#ifdef CONFIG_BOBBYCAR_CAN_RECORDER
+        BobbySchedulerTask{"canrec", can::recorder::init, can::recorder::update, 100ms, true, true},
+#endif
 #endif
+        BobbySchedulerTask{"drive", driving_modes::initDrive, driving_modes::updateDrive,
+                           CONFIG_BOBBYCAR_DRIVE_UPDATE_INTERVAL_MS * 1ms, true, false, false, nullptr,
+                           SchedulerClass::Realtime},
+        BobbySchedulerTask{"crashloop", init::initCrashLoop, init::updateCrashLoop, 1s, true},
+};
+
+constexpr int64_t TICK_US = portTICK_PERIOD_MS * 1000;
+
+constexpr auto STATS_INTERVAL = pdMS_TO_TICKS(1000);
+
+constexpr uint32_t REALTIME_STACK_SIZE = 8192;
+
+// deferred tasks are set up anyway if the control loop does not come up, e.g. with CAN disabled
+constexpr auto DEFERRED_SETUP_TIMEOUT = 2s;
+
+// worst values of one stats interval
+struct TaskStats
+{
+    int64_t worstJitter{};   // us between actual and nominal period
+    int64_t worstLateness{}; // us between deadline and start
+    uint32_t skippedPeriods{};
+};
+
+struct SchedulerStats
+{
+    std::array<TaskStats, std::size(tasksArray)> tasks{};
+    int64_t busy{};    // us spent in task loops
+    int64_t elapsed{}; // us the interval took
+};
+
+bool reached(const TickType_t deadline, const TickType_t now)
+{
+    return int32_t(now - deadline) >= 0;
+}
+
+TickType_t periodTicks(const BobbySchedulerTask &task)
+{
+    return std::max<TickType_t>(pdMS_TO_TICKS(task.scheduledInterval() / 1ms), 1);
+}
+
+// Runs the tasks of one SchedulerClass on the core it was started on. Every instance only touches its own tasks,
+// the stats of an interval are handed to the background instance through a SnapshotBuffer for printing.
+class Scheduler
+{
+public:
+    explicit Scheduler(const SchedulerClass schedulerClass) : m_class{schedulerClass}
+    {}
+
+    void setup(const bool in_recovery)
+    {
+        for (auto &task: tasksArray)
+            if (task.schedulerClass() == m_class) task.setup(in_recovery);
+    }
+
+    void delayedInit(const bool in_recovery)
+    {
+        for (auto &task: tasksArray)
+            if (task.schedulerClass() == m_class) task.delayedInit(in_recovery);
+    }
+
+    // runs the initialized tasks by earliest deadline and sleeps until the next one
+    template<typename F>
+    [[noreturn]] void run(F &&intervalDone)
+    {
+        m_epochTick = xTaskGetTickCount();
+        m_epochUs = esp_timer_get_time();
+        m_intervalStart = m_epochUs;
+
+        for (auto &timing: m_timings) timing.deadline = m_epochTick;
+
+        auto nextStats = m_epochTick + STATS_INTERVAL;
+
+        while (true)
+        {
+            while (const auto next = nextDue(xTaskGetTickCount())) runTask(*next, xTaskGetTickCount());
+
+            auto wake = xTaskGetTickCount();
+
+            if (reached(nextStats, wake))
+            {
+                publishStats();
+                intervalDone();
+                nextStats += STATS_INTERVAL;
+                continue;
+            }
+
+            // overruns fall through without sleeping, the next round picks the most overdue task first
+            if (const auto deadline = earliestDeadline(nextStats); !reached(deadline, wake))
+                xTaskDelayUntil(&wake, deadline - wake);
+        }
+    }
+
+    SchedulerClass schedulerClass() const
+    {
+        return m_class;
+    }
+
+    const SnapshotBuffer<SchedulerStats> &stats() const
+    {
+        return m_stats;
+    }
+
+private:
+    // deadlines are kept in ticks, so the loop can sleep with xTaskDelayUntil() and wakes up right on them
+    struct TaskTiming
+    {
+        TickType_t deadline{};
+        int64_t lastStart{}; // esp_timer_get_time()
+    };
+
+    bool runs(const size_t index) const
+    {
+        return tasksArray[index].schedulerClass() == m_class && tasksArray[index].isInitialized();
+    }
+
+    int64_t deadlineUs(const TickType_t deadline) const
+    {
+        return m_epochUs + int64_t(int32_t(deadline - m_epochTick)) * TICK_US;
+    }
+
+    void runTask(const size_t index, const TickType_t now)
+    {
+        auto &task = tasksArray[index];
+        auto &timing = m_timings[index];
+        auto &stats = m_current.tasks[index];
+
+        const auto period = periodTicks(task);
+        const auto start = esp_timer_get_time();
+
+        if (timing.lastStart)
+            stats.worstJitter = std::max(stats.worstJitter, std::abs(start - timing.lastStart - period * TICK_US));
+        stats.worstLateness = std::max(stats.worstLateness, start - deadlineUs(timing.deadline));
+
+        task.loop();
+
+        const auto duration = esp_timer_get_time() - start;
+        task.recordRun(start, uint32_t(duration), timing.lastStart ? uint32_t(start - timing.lastStart) : 0);
+        timing.lastStart = start;
+        m_current.busy += duration;
+
+        if (task.isIntervalImportant())
+        {
+            // keep the phase, periods that were missed entirely are dropped instead of run back to back
+            timing.deadline += period;
+            if (const auto after = xTaskGetTickCount(); reached(timing.deadline, after))
+            {
+                const auto skipped = (after - timing.deadline) / period + 1;
+                timing.deadline += skipped * period;
+                stats.skippedPeriods += skipped;
+            }
+        }
+        else
+        {
+            timing.deadline = now + period;
+        }
+    }
+
+    // earliest deadline of the tasks that are due at now, array order breaks ties
+    std::optional<size_t> nextDue(const TickType_t now) const
+    {
+        std::optional<size_t> next;
+        for (size_t i = 0; i < m_timings.size(); ++i)
+        {
+            if (!runs(i) || !reached(m_timings[i].deadline, now)) continue;
+            if (!next || int32_t(m_timings[i].deadline - m_timings[*next].deadline) < 0) next = i;
+        }
+        return next;
+    }
+
+    TickType_t earliestDeadline(const TickType_t fallback) const
+    {
+        auto earliest = fallback;
+        for (size_t i = 0; i < m_timings.size(); ++i)
+            if (runs(i) && int32_t(m_timings[i].deadline - earliest) < 0) earliest = m_timings[i].deadline;
+        return earliest;
+    }
+
+    void publishStats()
+    {
+        // background tasks are pushed by sched_pushStats() in intervalDone, which prints them along the way
+        if (m_class == SchedulerClass::Realtime)
+        {
+            for (auto &task: tasksArray)
+                if (task.schedulerClass() == m_class) task.pushStats(false);
+        }
+
+        const auto now = esp_timer_get_time();
+        m_current.elapsed = now - m_intervalStart;
+        m_intervalStart = now;
+
+        m_stats.publish(m_current);
+        m_current = {};
+    }
+
+    const SchedulerClass m_class;
+
+    std::array<TaskTiming, std::size(tasksArray)> m_timings{};
+
+    // tick and esp_timer_get_time() when the loop started, to express deadlines in us
+    TickType_t m_epochTick{};
+    int64_t m_epochUs{};
+
+    int64_t m_intervalStart{};
+    SchedulerStats m_current{};
+    SnapshotBuffer<SchedulerStats> m_stats{};
 };
 
+Scheduler realtimeScheduler{SchedulerClass::Realtime};
+Scheduler backgroundScheduler{SchedulerClass::Background};
+
+void realtimeSchedulerTask(void *arg)
+{
+    // set up here, so drivers installed by the tasks bind their interrupts to this core
+    realtimeScheduler.setup(*static_cast<const bool *>(arg));
+    boot::mark(boot::Phase::RealtimeSetup);
+
+    realtimeScheduler.run([] {});
+}
+
+void printStats(const Scheduler &scheduler, const char *name)
+{
+    SchedulerStats stats;
+    scheduler.stats().read(stats);
+
+    ESP_LOGI(TAG, "%s: utilization %lld%%", name, stats.elapsed ? stats.busy * 100 / stats.elapsed : 0);
+
+    for (size_t i = 0; i < stats.tasks.size(); ++i)
+    {
+        const auto &task = tasksArray[i];
+        if (task.schedulerClass() != scheduler.schedulerClass() || !task.isInitialized()) continue;
+
+        const auto &taskStats = stats.tasks[i];
+        ESP_LOGI(TAG, "%s: jitter %lldus, late %lldus, skipped %lu", task.name(), taskStats.worstJitter,
+                 taskStats.worstLateness, taskStats.skippedPeriods);
+
+        const auto &execution = task.executionHistogram();
+        const auto &period = task.periodHistogram();
+        const auto worst = task.worstOffender();
+        ESP_LOGI(TAG, "%s: loop p50<=%luus p99<=%luus max=%luus, period p50<=%luus p99<=%luus max=%luus", task.name(),
+                 execution.percentile(50), execution.percentile(99), execution.max(), period.percentile(50),
+                 period.percentile(99), period.max());
+        ESP_LOGI(TAG, "%s: overruns %lu, worst %luus at %lldms", task.name(), task.overruns(), worst.duration,
+                 worst.timestamp / 1000);
+    }
+}
+
 } // namespace
 
 cpputils::ArrayView<BobbySchedulerTask> tasks{tasksArray};
@@ -42,7 +315,56 @@ void sched_pushStats(const bool printTasks)
 {
     if (printTasks) ESP_LOGI(TAG, "begin listing tasks...");
 
-    for (auto &task: tasks) task.pushStats(printTasks);
+    for (auto &task: tasks)
+        if (task.schedulerClass() == SchedulerClass::Background) task.pushStats(printTasks);
+
+    if (printTasks)
+    {
+        printStats(realtimeScheduler, "realtime core");
+        printStats(backgroundScheduler, "background core");
+    }
 
     if (printTasks) ESP_LOGI(TAG, "end listing tasks");
+
+    if (printTasks) latency::printStats();
+}
+
+const BobbySchedulerTask *sched_findTask(const std::string_view name)
+{
+    for (const auto &task: tasks)
+        if (name == task.name()) return &task;
+    return nullptr;
+}
+
+void sched_runTasks(const bool in_recovery)
+{
+    static bool realtimeInRecovery;
+    realtimeInRecovery = in_recovery;
+
+    if (xTaskCreatePinnedToCore(realtimeSchedulerTask, "sched_rt", REALTIME_STACK_SIZE, &realtimeInRecovery,
+                                CONFIG_BOBBYCAR_SCHEDULER_REALTIME_PRIORITY, nullptr,
+                                CONFIG_BOBBYCAR_SCHEDULER_REALTIME_CORE) != pdPASS)
+    {
+        ESP_LOGE(TAG, "xTaskCreatePinnedToCore() for sched_rt failed");
+        abort();
+    }
+
+    backgroundScheduler.setup(in_recovery);
+    boot::mark(boot::Phase::BackgroundSetup);
+
+    // deferred tasks wait for the first control tick, so they never compete with bringing up CAN and control
+    if (!boot::waitFor(boot::Phase::FirstControlTick, DEFERRED_SETUP_TIMEOUT))
+        ESP_LOGW(TAG, "no control tick after %lldms, setting up deferred tasks anyway",
+                 std::chrono::milliseconds{DEFERRED_SETUP_TIMEOUT}.count());
+
+    backgroundScheduler.delayedInit(in_recovery);
+    boot::mark(boot::Phase::DeferredSetup);
+
+    boot::printTimeline();
+
+    if (in_recovery)
+        ESP_LOGW(TAG, "recovery boot, safe command after %lldms",
+                 boot::reached(boot::Phase::FirstInpTgt) ? boot::timestamp(boot::Phase::FirstInpTgt) / 1000 : -1);
+
+    backgroundScheduler.run([] { sched_pushStats(PRINT_TASK_STATS); });
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+// system includes
+#include <string_view>
+
 // 3rdparty lib includes
 #include <arrayview.h>
 
@@ -8,4 +11,15 @@
 
 extern cpputils::ArrayView<BobbySchedulerTask> tasks;
 
-void sched_pushStats(bool printTasks);
\ No newline at end of file
+// the only place the stats of the background tasks get pushed, also prints those of both schedulers. Called by the
+// background scheduler once per second.
+void sched_pushStats(bool printTasks);
+
+// for runtime queries of the per task histograms, nullptr if there is no task of that name
+const BobbySchedulerTask *sched_findTask(std::string_view name);
+
+// Sets up and runs the realtime tasks in their own FreeRTOS task pinned to CONFIG_BOBBYCAR_SCHEDULER_REALTIME_CORE,
+// while the background tasks are set up on the calling task at the same time. Background tasks with init_later are
+// only set up after the first control tick, then the calling task runs the background tasks. Realtime tasks are
+// never deferred. Tasks without use_in_recovery are skipped in recovery.
+[[noreturn]] void sched_runTasks(bool in_recovery);
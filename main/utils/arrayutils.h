@@ -0,0 +1,19 @@
+#pragma once
+
+// system includes
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace arrayutils {
+
+template<typename T, size_t... N>
+constexpr auto concat(const std::array<T, N> &...arrays)
+{
+    std::array<T, (N + ...)> result{};
+    auto it = result.begin();
+    ((it = std::ranges::copy(arrays, it).out), ...);
+    return result;
+}
+
+} // namespace arrayutils
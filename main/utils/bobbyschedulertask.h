@@ -1,19 +1,47 @@
 #pragma once
 
+// system includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
 // 3rdparty lib includes
 #include <schedulertask.h>
 
 #include <esp_log.h>
 
+// local includes
+#include "utils/loghistogram.h"
+#include "utils/snapshotbuffer.h"
+
+// Realtime tasks (CAN, control) get a scheduler of their own on a separate core, so nothing in the background can
+// delay them. Data between the two goes through atomics, SnapshotBuffer or SpscRing only.
+enum class SchedulerClass : uint8_t
+{
+    Realtime,
+    Background
+};
+
 class BobbySchedulerTask : public espcpputils::SchedulerTask
 {
 public:
+    using Histogram = LogHistogram<24>;
+
+    // slowest loop() so far
+    struct Offender
+    {
+        uint32_t duration; // us
+        int64_t timestamp; // esp_timer_get_time() when it started
+    };
+
     // using SchedulerTask::SchedulerTask; -> we need to add one more parameter
     BobbySchedulerTask(const char *name, void (&setupCallback)(), void (&loopCallback)(),
                        espchrono::millis_clock::duration loopInterval, bool use_in_recovery = false,
-                       bool init_later = false, bool intervalImportant = false, std::string (*perfInfo)() = nullptr) :
+                       bool init_later = false, bool intervalImportant = false, std::string (*perfInfo)() = nullptr,
+                       SchedulerClass schedulerClass = SchedulerClass::Background) :
         espcpputils::SchedulerTask(name, setupCallback, loopCallback, loopInterval, intervalImportant, perfInfo),
-        m_use_in_recovery{use_in_recovery}, m_init_later{init_later}
+        m_use_in_recovery{use_in_recovery}, m_init_later{init_later}, m_loop_interval{loopInterval},
+        m_interval_important{intervalImportant}, m_scheduler_class{schedulerClass}
     {
     }
     void setup(bool in_recovery = false, bool force = false)
@@ -44,11 +72,12 @@ public:
             SchedulerTask::loop();
         }
     }
-    void delayedInit()
+    // a recovery boot keeps skipping the tasks without use_in_recovery here as well
+    void delayedInit(bool in_recovery = false)
     {
-        if (m_init_later && !m_wasInitialized)
+        if (m_init_later && !m_wasInitialized && (!in_recovery || m_use_in_recovery))
         {
-            setup(false, true);
+            setup(in_recovery, true);
             m_init_later = false;
         }
     }
@@ -60,10 +89,68 @@ public:
     {
         return m_init_later;
     }
+    espchrono::millis_clock::duration scheduledInterval() const
+    {
+        return m_loop_interval;
+    }
+    bool isIntervalImportant() const
+    {
+        return m_interval_important;
+    }
+    SchedulerClass schedulerClass() const
+    {
+        return m_scheduler_class;
+    }
+
+    // called by the scheduler loop after every loop(), period is 0 for the first run
+    void recordRun(const int64_t start, const uint32_t duration, const uint32_t period)
+    {
+        m_execution.record(duration);
+        if (period) m_period.record(period);
+
+        if (std::chrono::microseconds{duration} > m_loop_interval) m_overruns.fetch_add(1, std::memory_order_relaxed);
+
+        if (duration > m_worst_duration)
+        {
+            m_worst_duration = duration;
+            m_worst_offender.publish({duration, start});
+        }
+    }
+
+    // loop() durations in us since boot, readable from any task
+    const Histogram &executionHistogram() const
+    {
+        return m_execution;
+    }
+    // us between the starts of two loop() runs since boot, readable from any task
+    const Histogram &periodHistogram() const
+    {
+        return m_period;
+    }
+    // loop() runs that took longer than loopInterval
+    uint32_t overruns() const
+    {
+        return m_overruns.load(std::memory_order_relaxed);
+    }
+    Offender worstOffender() const
+    {
+        Offender offender;
+        m_worst_offender.read(offender);
+        return offender;
+    }
 
 private:
     mutable bool m_wasInitialized{false};
     const bool m_use_in_recovery;
     bool m_init_later;
     bool m_in_recovery{false};
+    const espchrono::millis_clock::duration m_loop_interval;
+    const bool m_interval_important;
+    const SchedulerClass m_scheduler_class;
+
+    Histogram m_execution;
+    Histogram m_period;
+    std::atomic<uint32_t> m_overruns{};
+    uint32_t m_worst_duration{}; // only touched by the scheduler loop
+    SnapshotBuffer<Offender> m_worst_offender;
 };
@@ -0,0 +1,87 @@
+#include "boottimeline.h"
+
+constexpr auto TAG = "BOOT";
+
+// system includes
+#include <array>
+#include <atomic>
+
+// esp-idf includes
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+namespace boot {
+
+namespace {
+    std::array<std::atomic<int64_t>, PHASE_COUNT> timestamps{};
+} // namespace
+
+void mark(const Phase phase)
+{
+    auto &slot = timestamps[uint8_t(phase)];
+    if (slot.load(std::memory_order_relaxed)) return;
+
+    int64_t expected{0};
+    slot.compare_exchange_strong(expected, esp_timer_get_time(), std::memory_order_release);
+}
+
+bool reached(const Phase phase)
+{
+    return timestamp(phase) != 0;
+}
+
+int64_t timestamp(const Phase phase)
+{
+    return timestamps[uint8_t(phase)].load(std::memory_order_acquire);
+}
+
+bool waitFor(const Phase phase, const std::chrono::milliseconds timeout)
+{
+    // only used while booting, polling once per tick is good enough
+    constexpr std::chrono::milliseconds TICK{portTICK_PERIOD_MS};
+
+    for (auto waited = std::chrono::milliseconds{}; !reached(phase) && waited < timeout; waited += TICK)
+        vTaskDelay(1);
+
+    return reached(phase);
+}
+
+const char *phaseName(const Phase phase)
+{
+    switch (phase)
+    {
+        case Phase::AppMain:
+            return "app_main";
+        case Phase::ConfigInit:
+            return "config init";
+        case Phase::ProfileSelected:
+            return "profile selected";
+        case Phase::RealtimeSetup:
+            return "realtime setup";
+        case Phase::BackgroundSetup:
+            return "background setup";
+        case Phase::FirstControlTick:
+            return "first control tick";
+        case Phase::FirstInpTgt:
+            return "first InpTgt";
+        case Phase::DeferredSetup:
+            return "deferred setup";
+    }
+    return "unknown";
+}
+
+void printTimeline()
+{
+    for (uint8_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        const auto phase = Phase(i);
+        if (reached(phase))
+            ESP_LOGI(TAG, "%-18s %lldms", phaseName(phase), timestamp(phase) / 1000);
+        else
+            ESP_LOGI(TAG, "%-18s not reached", phaseName(phase));
+    }
+}
+
+} // namespace boot
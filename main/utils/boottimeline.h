@@ -0,0 +1,39 @@
+#pragma once
+
+// system includes
+#include <chrono>
+#include <cstdint>
+
+// Milliseconds since reset at which each startup phase was reached. Every phase is recorded once, marking it again
+// is a cheap no-op, so the hot paths can mark the first occurrence of something unconditionally.
+namespace boot {
+
+enum class Phase : uint8_t
+{
+    AppMain,          // app_main() entered
+    ConfigInit,       // configs loaded from nvs
+    ProfileSelected,  // config snapshot published
+    RealtimeSetup,    // setup() of every realtime task done
+    BackgroundSetup,  // setup() of the background tasks that are not deferred done
+    FirstControlTick, // first driving mode update
+    FirstInpTgt,      // first InpTgt frame accepted by the driver
+    DeferredSetup,    // setup() of the deferred tasks done
+};
+
+constexpr uint8_t PHASE_COUNT = 8;
+
+void mark(Phase phase);
+
+bool reached(Phase phase);
+
+// esp_timer_get_time() when the phase was marked, 0 if it was not reached yet
+int64_t timestamp(Phase phase);
+
+// sleeps until the phase is reached or the timeout expired, returns reached(phase)
+bool waitFor(Phase phase, std::chrono::milliseconds timeout);
+
+const char *phaseName(Phase phase);
+
+void printTimeline();
+
+} // namespace boot
@@ -0,0 +1,92 @@
+#include "crashloop.h"
+
+// sdkconfig includes
+#include "sdkconfig.h"
+
+constexpr auto TAG = "CRASHLOOP";
+
+// esp-idf includes
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+namespace init {
+
+RTC_NOINIT_ATTR bool recovery;
+
+namespace {
+    // RTC_NOINIT memory holds garbage after power on, the counter only counts while the magic matches
+    constexpr uint32_t MAGIC = 0xB0BB1C4A;
+
+    constexpr int64_t STABLE_US = int64_t{CONFIG_BOBBYCAR_CRASH_LOOP_STABLE_S} * 1000000;
+
+    RTC_NOINIT_ATTR uint32_t rtcMagic;
+    RTC_NOINIT_ATTR uint32_t rtcCrashCount;
+
+    esp_reset_reason_t reason{ESP_RST_UNKNOWN};
+    uint32_t crashes{};
+    bool cleared{};
+
+    bool isCrash(const esp_reset_reason_t reason)
+    {
+        switch (reason)
+        {
+            case ESP_RST_PANIC:
+            case ESP_RST_INT_WDT:
+            case ESP_RST_TASK_WDT:
+            case ESP_RST_WDT:
+            case ESP_RST_BROWNOUT:
+                return true;
+            default:
+                return false;
+        }
+    }
+} // namespace
+
+void checkCrashLoop()
+{
+    reason = esp_reset_reason();
+
+    if (rtcMagic != MAGIC || !isCrash(reason))
+    {
+        rtcMagic = MAGIC;
+        rtcCrashCount = 0;
+    }
+
+    if (isCrash(reason)) ++rtcCrashCount;
+
+    crashes = rtcCrashCount;
+    recovery = crashes >= CONFIG_BOBBYCAR_CRASH_LOOP_THRESHOLD;
+
+    if (recovery)
+        ESP_LOGW(TAG, "%lu crashes in a row (last reset reason %d), booting into recovery", crashes, int(reason));
+    else if (crashes)
+        ESP_LOGW(TAG, "%lu crashes in a row (last reset reason %d)", crashes, int(reason));
+}
+
+uint32_t crashCount()
+{
+    return crashes;
+}
+
+esp_reset_reason_t resetReason()
+{
+    return reason;
+}
+
+void initCrashLoop()
+{
+}
+
+void updateCrashLoop()
+{
+    if (cleared || esp_timer_get_time() < STABLE_US) return;
+
+    // a crash after this point counts as the first one again
+    rtcCrashCount = 0;
+    cleared = true;
+
+    if (crashes) ESP_LOGI(TAG, "up for %ds, crash counter cleared", CONFIG_BOBBYCAR_CRASH_LOOP_STABLE_S);
+}
+
+} // namespace init
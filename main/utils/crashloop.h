@@ -0,0 +1,28 @@
+#pragma once
+
+// system includes
+#include <cstdint>
+
+// esp-idf includes
+#include <esp_system.h>
+
+// Counts crashes across resets in RTC memory. After CONFIG_BOBBYCAR_CRASH_LOOP_THRESHOLD crashes in a row the
+// boardcomputer boots into recovery, which only sets up the tasks with use_in_recovery.
+namespace init {
+
+// set by checkCrashLoop() before any task is set up
+extern bool recovery;
+
+// evaluates the reset reason and the RTC crash counter, has to run first thing in app_main()
+void checkCrashLoop();
+
+// crashes in a row including the one that caused this boot
+uint32_t crashCount();
+
+esp_reset_reason_t resetReason();
+
+// scheduler task, clears the crash counter once the boardcomputer stayed up long enough
+void initCrashLoop();
+void updateCrashLoop();
+
+} // namespace init
@@ -0,0 +1,112 @@
+#include "latencytrace.h"
+
+constexpr auto TAG = "LATENCY";
+
+// system includes
+#include <array>
+#include <atomic>
+#include <limits>
+
+// esp-idf includes
+#include <esp_log.h>
+#include <esp_timer.h>
+
+namespace latency {
+
+namespace {
+
+    constexpr int64_t TRACE_TIMEOUT_US = 1000000;
+
+    constexpr uint8_t bit(const Stage stage)
+    {
+        return uint8_t(1u << uint8_t(stage));
+    }
+
+    std::array<Histogram, STAGE_COUNT> histograms;
+
+    std::atomic<int32_t> lastValue{std::numeric_limits<int32_t>::min()};
+
+    // esp_timer_get_time() of the input sample, 0 while no trace is running
+    std::atomic<int64_t> traceStart{0};
+    std::atomic<uint8_t> marked{0};
+
+    std::atomic<uint32_t> abandoned{0};
+
+} // namespace
+
+void inputSampled(const int32_t value)
+{
+    if (lastValue.exchange(value, std::memory_order_relaxed) == value) return;
+
+    const auto now = esp_timer_get_time();
+
+    if (const auto start = traceStart.load(std::memory_order_acquire))
+    {
+        if (now - start < TRACE_TIMEOUT_US) return;
+        abandoned.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    marked.store(bit(Stage::InputSample), std::memory_order_relaxed);
+    traceStart.store(now, std::memory_order_release);
+}
+
+void mark(const Stage stage)
+{
+    const auto start = traceStart.load(std::memory_order_acquire);
+    if (!start) return;
+
+    const uint8_t required = bit(stage) - 1;
+    auto bits = marked.load(std::memory_order_relaxed);
+    if ((bits & required) != required || (bits & bit(stage))) return;
+    if (!marked.compare_exchange_strong(bits, bits | bit(stage), std::memory_order_relaxed)) return;
+
+    histograms[uint8_t(stage)].record(uint32_t(esp_timer_get_time() - start));
+
+    if (stage == Stage::TxEnqueue)
+    {
+        traceStart.store(0, std::memory_order_relaxed);
+        marked.store(0, std::memory_order_relaxed);
+    }
+}
+
+const Histogram &histogram(const Stage stage)
+{
+    return histograms[uint8_t(stage)];
+}
+
+const char *stageName(const Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::InputSample:
+            return "InputSample";
+        case Stage::InputHandOff:
+            return "InputHandOff";
+        case Stage::ModeUpdate:
+            return "ModeUpdate";
+        case Stage::CommandBuild:
+            return "CommandBuild";
+        case Stage::TxEnqueue:
+            return "TxEnqueue";
+    }
+    return "Unknown";
+}
+
+uint32_t abandonedTraces()
+{
+    return abandoned.load(std::memory_order_relaxed);
+}
+
+void printStats()
+{
+    for (uint8_t i = uint8_t(Stage::InputHandOff); i < STAGE_COUNT; ++i)
+    {
+        const auto stage = Stage(i);
+        const auto &h = histogram(stage);
+        ESP_LOGI(TAG, "%-12s n=%lu p50<=%luus p99<=%luus max=%luus", stageName(stage), h.count(), h.percentile(50),
+                 h.percentile(99), h.max());
+    }
+    ESP_LOGI(TAG, "abandoned traces: %lu", abandonedTraces());
+}
+
+} // namespace latency
@@ -0,0 +1,43 @@
+#pragma once
+
+// system includes
+#include <cstdint>
+
+// local includes
+#include "utils/loghistogram.h"
+
+// End to end latency from a gas input change to the InpTgt frame that carries it being handed to the driver. Only one
+// change is traced at a time, every stage is recorded as time since the input sample. The time on the wire is not
+// traced, TWAI only reports TX_SUCCESS as an alert for the whole controller and not for a specific frame.
+namespace latency {
+
+enum class Stage : uint8_t
+{
+    InputSample,  // gas value changed
+    InputHandOff, // value stored into can::inputs for the driving mode
+    ModeUpdate,   // driving mode picked the value up
+    CommandBuild, // Controller::command written
+    TxEnqueue,    // InpTgt frames accepted by twai_transmit(), ends the trace
+};
+
+constexpr uint8_t STAGE_COUNT = 5;
+
+using Histogram = LogHistogram<24>;
+
+// starts a trace if value differs from the previous sample and no trace is running
+void inputSampled(int32_t value);
+
+// records a stage of the running trace, ignored unless every earlier stage was already marked
+void mark(Stage stage);
+
+// microseconds from InputSample to the given stage, empty for Stage::InputSample itself
+const Histogram &histogram(Stage stage);
+
+const char *stageName(Stage stage);
+
+// traces dropped because they did not reach TxEnqueue within a second
+uint32_t abandonedTraces();
+
+void printStats();
+
+} // namespace latency
@@ -0,0 +1,70 @@
+#pragma once
+
+// system includes
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+// Fixed memory histogram with power of two buckets: bucket 0 counts 0, bucket i counts [2^(i-1), 2^i), the last
+// bucket also takes everything above. Recording is wait free and may happen from a different task than reading.
+template<size_t BucketCount = 24>
+class LogHistogram
+{
+    static_assert(BucketCount >= 2 && BucketCount <= 33);
+
+public:
+    void record(const uint32_t value)
+    {
+        const size_t bucket = std::min<size_t>(std::bit_width(value), BucketCount - 1);
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        auto max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    uint32_t count() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    uint32_t max() const
+    {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    // upper bound of the bucket holding the given percentile, never above max()
+    uint32_t percentile(const uint32_t percent) const
+    {
+        const uint64_t total = count();
+        if (!total) return 0;
+
+        const uint64_t rank = (total * percent + 99) / 100;
+        uint64_t seen{};
+        for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+        {
+            seen += m_buckets[bucket].load(std::memory_order_relaxed);
+            if (seen >= rank) return bucket == BucketCount - 1 ? max() : std::min(upperBound(bucket), max());
+        }
+        return max();
+    }
+
+    void reset()
+    {
+        for (auto &bucket: m_buckets) bucket.store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t upperBound(const size_t bucket)
+    {
+        return bucket == 0 ? 0 : uint32_t((uint64_t{1} << bucket) - 1);
+    }
+
+    std::array<std::atomic<uint32_t>, BucketCount> m_buckets{};
+    std::atomic<uint32_t> m_count{};
+    std::atomic<uint32_t> m_max{};
+};
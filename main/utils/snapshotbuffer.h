@@ -0,0 +1,73 @@
+#pragma once
+
+// system includes
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+// double buffered value with a generation counter, one writer task and any number of reader tasks.
+// The writer always fills the buffer readers are not pointed at, so a reader preempting the writer
+// on the same core still gets a consistent copy without retrying.
+template<typename T>
+class SnapshotBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SnapshotBuffer needs a trivially copyable type");
+
+public:
+    // writer side
+    void publish(const T &value)
+    {
+        const auto generation = m_generation.load(std::memory_order_relaxed);
+
+        // readers of generation - 1 may still copy the buffer we are about to overwrite, they detect that
+        // because the generation moved on when they re-check it
+        std::atomic_thread_fence(std::memory_order_release);
+        m_buffers[(generation + 1) & 1] = value;
+        m_generation.store(generation + 1, std::memory_order_release);
+    }
+
+    // reader side, returns the generation of the copied snapshot
+    uint32_t read(T &value) const
+    {
+        while (true)
+        {
+            const auto generation = m_generation.load(std::memory_order_acquire);
+            value = m_buffers[generation & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_generation.load(std::memory_order_relaxed) == generation) return generation;
+        }
+    }
+
+    // reader side, only copies what project() picks out of the snapshot
+    template<typename F>
+        requires std::is_invocable_v<F, const T &>
+    auto read(F &&project) const
+    {
+        while (true)
+        {
+            const auto generation = m_generation.load(std::memory_order_acquire);
+            const auto result = project(m_buffers[generation & 1]);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_generation.load(std::memory_order_relaxed) == generation) return result;
+        }
+    }
+
+    // reader side, only copies if something was published since generation
+    bool readIfChanged(T &value, uint32_t &generation) const
+    {
+        if (m_generation.load(std::memory_order_acquire) == generation) return false;
+
+        generation = read(value);
+        return true;
+    }
+
+    uint32_t generation() const
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, 2> m_buffers{};
+    std::atomic<uint32_t> m_generation{0};
+};
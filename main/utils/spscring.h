@@ -0,0 +1,52 @@
+#pragma once
+
+// system includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// lock-free ring for exactly one producer task and one consumer task
+template<typename T, size_t N>
+class SpscRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // producer side
+    bool push(const T &value)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == N) return false;
+
+        m_buffer[head & (N - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    bool pop(T &value)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail) return false;
+
+        value = m_buffer[tail & (N - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // only a snapshot, the producer might push concurrently
+    size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity()
+    {
+        return N;
+    }
+
+private:
+    std::array<T, N> m_buffer{};
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+};